@@ -75,7 +75,7 @@ int main(void)
 	Task_Init();
 	UART_Init(SUBSYSTEM_UART);
 	/* Increase the baud rate for faster response */
-	UART_ReconfigureBaud(SUBSYSTEM_UART, 460800);
+	UART_ReconfigureBaud(SUBSYSTEM_UART, GAME_UART_BAUD);
 	EnableInterrupts();
 
 	/* Initialize LED blinking subsystem for logging */
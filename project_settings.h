@@ -34,8 +34,22 @@
 #define USE_UART0
 #define SUBSYSTEM_IO SUBSYSTEM_IO_UART
 #define SUBSYSTEM_UART 0
+#define GAME_UART_BAUD 460800
 
+#ifndef TASK_MAX_LENGTH
 #define TASK_MAX_LENGTH 50
+#endif
+
+/* Scheduler behind Task_Schedule(). The list is the library's task.c,
+ * the heap in task_heap.c only walks the tasks that are due. task.c is
+ * linked in from the library so picking the heap also needs it excluded
+ * from the build, the Debug_Heap build configuration does both.
+ */
+#define TASK_BACKEND_LIST 0
+#define TASK_BACKEND_HEAP 1
+#ifndef TASK_BACKEND
+#define TASK_BACKEND TASK_BACKEND_LIST
+#endif
 
 
 #endif /* PROJECT_SETTINGS_H_ */
@@ -0,0 +1,1039 @@
+/**
+ * @file screen.c
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Shadow framebuffer for the game terminal
+ *
+ * Every cell holds the glyph and the color the terminal should show. A
+ * write only marks the cell dirty when it actually changes something, so
+ * redrawing an unchanged cell costs nothing on the wire.
+ *
+ * The flush also remembers where the terminal cursor is and reaches each
+ * dirty cell with the cheapest sequence available (nothing for the next
+ * cell, CR/LF, backspace, a relative move or an absolute position). This
+ * assumes the terminal does not add an implicit CR to every LF.
+ *
+ * The color the terminal is printing with is remembered between flushes
+ * and dirty cells are sent grouped by color, so each color is switched to
+ * at most once per flush no matter how often the game changes its pen.
+ *
+ * Each flush is limited to the bytes the UART transmit buffer can take
+ * without blocking. The budget refills at the baud rate for the time that
+ * passed since the previous flush, so it follows whatever tick period the
+ * game uses. What happens when a frame does not fit depends on the
+ * backpressure mode. By default cells are kept dirty for a later flush,
+ * which only sends their latest value: first the status rows are held
+ * back, then the part of the field far from the focus point. A frame can
+ * also be held back as a whole, or sent anyway with the UART waiting for
+ * room.
+ *
+ * Output is collected in a small staging span and handed to the UART with
+ * one write per span instead of one call per byte. The span is always
+ * emptied before a Screen_ call returns so it never reorders with output
+ * the game module sends itself.
+ *
+ * Everything sent between two calls to Screen_Flush is one frame and can be
+ * wrapped in a synchronized update so the terminal shows it all at once.
+ * Terminals without synchronized updates still never see a frame mixed
+ * with the next one since it is composed in the framebuffer and sent in a
+ * single burst.
+ *
+ * Instead of terminal sequences the frames can also be sent in a compact
+ * binary format for a client on the host to draw, see screen_protocol.h.
+ *
+ * Runs of blanks are cleared with erase character or erase line, so a
+ * sparse field costs bytes per asteroid rather than per cell.
+ *
+ * Scrolling can be left to the terminal: either with delete/insert
+ * character on every row or with left/right margins and a single scroll
+ * left sequence. The framebuffer is shifted along with it so the redraw
+ * that follows only sends what is new.
+ */
+
+#include "project_settings.h"
+#include "game.h"
+#include "terminal.h"
+#include "uart.h"
+#include "task.h"
+#include "task_handle.h"
+#include "timing.h"
+#include "screen.h"
+#include "screen_protocol.h"
+
+// Colors are stored as a foreground index in the high nibble and a background index in the low nibble
+#define PACK_COLOR(fg, bg)          ((((fg) - ForegroundBlack) << 4) | ((bg) - BackgroundBlack))
+#define COLOR_FG(color)             ((enum term_color)(((color) >> 4) + ForegroundBlack))
+#define COLOR_BG(color)             ((enum term_color)(((color) & 0x0F) + BackgroundBlack))
+#define DEFAULT_COLOR               PACK_COLOR(ForegroundWhite, BackgroundBlack)
+
+#define DIRTY_BYTES                 ((SCREEN_WIDTH + 7) / 8)
+#define IS_DIRTY(x, y)              (dirty[y][(x) >> 3] & (1 << ((x) & 7)))
+#define CELL_BIT(x)                 ((uint64_t)1 << (x))
+
+// Ways of reaching a cell picked by MoveCursor
+#define MOVE_ABSOLUTE               0               // cursor position sequence
+#define MOVE_RELATIVE               1               // relative moves from where the cursor is
+#define MOVE_RETURN                 2               // carriage return then relative moves
+
+// Rough byte costs used to decide if letting the terminal scroll is worth it
+#define REDRAW_CELL_COST            4               // reaching and printing a single changed cell
+#define DCH_SCROLL_COST             6               // delete and insert character
+#define MARGIN_SCROLL_COST          40              // setting and clearing the margins, scrolling and finding the cursor again
+#define ERASE_LINE_COST             3               // erase to the end of the line
+
+// Budget for each flush, the link sends a byte per 10 bits
+#define BYTES_PER_SECOND            (SCREEN_BAUD / 10) // until the link has been measured
+#define MAX_CELL_COST               17              // absolute position, two color change and the glyph
+#define MAX_DCH_COST                27              // absolute position, color change, delete, forward and insert
+#define MAX_MARGIN_COST             43              // color change, setting the margins, scrolling and clearing them
+#define RETRY_DELAY                 ((SCREEN_TX_BUFFER_LENGTH / 4) * 1000UL / linkRate + 1) // ms to drain a quarter of the buffer
+
+// Order cells are sent in when the budget runs short
+#define TIER_NEAR                   0               // field cells close to the focus point
+#define TIER_FAR                    1               // field cells far from the focus point
+#define TIER_STATUS                 2               // status rows below the field
+#define TIER_COUNT                  3
+
+#define STAGE_LENGTH                32              // bytes collected before they are handed to the UART
+
+// Link test pattern, each line is printed over the last one and erased at the end
+#define LINK_LINE_LENGTH            64              // bytes in each line of the pattern
+#define LINK_LINES                  64              // lines in the pattern
+#define LINK_FILL_LINES             ((SCREEN_TX_BUFFER_LENGTH - 1) / LINK_LINE_LENGTH) // lines written before waiting for the buffer to empty
+#define LINK_TIMEOUT                2000            // ms to wait for the UART to go idle
+
+#define SYNC_START_COST             8               // opening a synchronized update
+#define SYNC_END_COST               8               // closing a synchronized update
+#define SYNC_ON                     (syncUpdate && outputMode == SCREEN_OUTPUT_ANSI)
+#define BINARY_START_COST           (3 + SCREEN_PROTOCOL_ROW_GROUPS) // start and rows of a binary frame at most
+
+// the host client only knows the protocol's geometry and binary frames send the dirty bytes as column groups
+#if SCREEN_PROTOCOL_ROWS != SCREEN_HEIGHT || SCREEN_PROTOCOL_COLUMNS != SCREEN_WIDTH
+#error "screen_protocol.h has to cover the same rows and columns as screen.h"
+#endif
+#if SCREEN_PROTOCOL_GROUP_WIDTH != 8 || SCREEN_PROTOCOL_COLUMN_GROUPS != DIRTY_BYTES
+#error "binary frames send a row's dirty bytes as its column groups"
+#endif
+
+#define UNKNOWN_GLYPH               0               // cell drawn outside the framebuffer
+#define NO_COLOR                    0xFF            // terminal color is not known
+
+static uint8_t glyphs[SCREEN_HEIGHT][SCREEN_WIDTH]; ///< glyph the terminal should show
+static uint8_t colors[SCREEN_HEIGHT][SCREEN_WIDTH]; ///< packed color the terminal should show
+static uint8_t dirty[SCREEN_HEIGHT][DIRTY_BYTES]; ///< one bit per cell that has not been sent yet
+static uint32_t dirtyRows; ///< one bit per row with at least one dirty cell
+
+static enum term_color penFg = ForegroundWhite; ///< foreground used for new cells
+static enum term_color penBg = BackgroundBlack; ///< background used for new cells
+
+static uint8_t cursorX; ///< column the terminal cursor is on
+static uint8_t cursorY; ///< row the terminal cursor is on
+static uint8_t cursorKnown; ///< set when cursorX and cursorY can be trusted
+
+static uint8_t scrollMode = SCREEN_SCROLL_MODE; ///< how Screen_ScrollLeft moves the terminal contents
+static uint8_t shownColor = NO_COLOR; ///< color the terminal is currently printing with
+
+static int32_t budget = SCREEN_TX_BUFFER_LENGTH; ///< bytes that can still be sent without blocking
+static uint32_t linkRate = BYTES_PER_SECOND; ///< bytes per second the UART actually sends
+static tint_t budgetTime; ///< time the budget was last refilled
+static task_handle_t retry; ///< flush scheduled for deferred cells, TASK_NO_HANDLE when there is none
+static uint8_t statusRow = SCREEN_HEIGHT; ///< first row of the status area
+static uint8_t focusX; ///< column the player is looking at
+static screen_stats_t stats; ///< counters for Screen_GetStats
+
+static uint8_t backpressure = SCREEN_BACKPRESSURE; ///< what to do when the UART falls behind
+static uint8_t outputMode = SCREEN_OUTPUT_MODE; ///< format frames are sent in
+static uint8_t syncUpdate = SCREEN_SYNC_UPDATE; ///< bracket each frame in a synchronized update
+static uint8_t frameOpen; ///< something was sent since the last Screen_Flush
+static uint32_t frameStart; ///< stats.bytes when the frame was opened
+
+static char stage[STAGE_LENGTH]; ///< bytes waiting to be handed to the UART
+static uint8_t staged; ///< number of bytes in stage
+
+static uint8_t keptX[SCREEN_KEEP_LENGTH]; ///< column of each cell that stays put over the next scroll
+static uint8_t keptY[SCREEN_KEEP_LENGTH]; ///< row of each cell that stays put over the next scroll
+static uint8_t keptCount; ///< cells in keptX and keptY
+
+// Color changes with the digits patched in by SetColor, color codes are always two digits
+static char sgrPair[] = "\x1B[30;40m";
+static char sgrSingle[] = "\x1B[30m";
+
+static uint16_t RedrawCost(uint8_t x_min, uint8_t x_max, uint8_t y, uint8_t scrolled);
+static uint8_t ScrolledCell(uint8_t x, uint8_t x_max, uint8_t y, uint64_t kept, uint8_t scrolled, uint8_t * glyph,
+                            uint8_t * color);
+static uint64_t KeptCells(uint8_t y);
+static uint8_t PositionCost(uint8_t x, uint8_t y);
+static uint8_t ColorCost(uint8_t from, uint8_t to);
+static void ShiftRow(uint8_t x_min, uint8_t x_max, uint8_t y);
+static void Emit(char c);
+static void Drain(void);
+static void EmitString(const char * str);
+static void EmitNumber(uint8_t n);
+static void EmitPair(uint8_t a, uint8_t b, char command);
+static void EmitCsi(uint8_t n, char command);
+static uint8_t Digits(uint8_t n);
+static uint8_t CsiCost(uint8_t n);
+static uint8_t CanReprint(uint8_t from, uint8_t to, uint8_t y, uint8_t color);
+static uint8_t HorizontalCost(uint8_t from, uint8_t to, uint8_t y, uint8_t color);
+static void MoveHorizontal(uint8_t from, uint8_t to, uint8_t y, uint8_t color);
+static void MoveCursor(uint8_t x, uint8_t y, uint8_t color);
+static void SetColor(uint8_t color);
+static uint8_t CellTier(uint8_t x, uint8_t y);
+static void RefillBudget(void);
+static void RetryFlush(void);
+static uint8_t RowDirty(uint8_t x_min, uint8_t x_max, uint8_t y);
+static uint8_t ScrollFits(uint8_t cost);
+static uint8_t BlankRun(uint8_t x, uint8_t y, uint8_t color);
+static void SendCells(void);
+static void HoldBack(void);
+static void SendBinary(void);
+static uint16_t FrameCost(void);
+static void OpenFrame(void);
+static uint16_t CloseFrame(void);
+
+void Screen_Init(void) {
+    uint8_t x, y;
+    for(y = 0; y < SCREEN_HEIGHT; y++) {
+        for(x = 0; x < SCREEN_WIDTH; x++) {
+            glyphs[y][x] = ' ';
+            colors[y][x] = DEFAULT_COLOR;
+        }
+        for(x = 0; x < DIRTY_BYTES; x++) dirty[y][x] = 0;
+    }
+    dirtyRows = 0;
+    penFg = ForegroundWhite;
+    penBg = BackgroundBlack;
+    cursorKnown = 0;
+    shownColor = NO_COLOR;
+    // clearing the screen may have filled the transmit buffer, wait for it to drain
+    budget = 0;
+    budgetTime = TimeNow();
+}
+
+void Screen_DrawRect(uint8_t x_min, uint8_t y_min, uint8_t x_max, uint8_t y_max) {
+    uint8_t i;
+    Game_DrawRect(x_min, y_min, x_max, y_max);
+    // the border glyphs are up to the game module so never reprint them
+    if(x_max >= SCREEN_WIDTH) x_max = SCREEN_WIDTH - 1;
+    if(y_max >= SCREEN_HEIGHT) y_max = SCREEN_HEIGHT - 1;
+    for(i = x_min; i <= x_max; i++) {
+        glyphs[y_min][i] = UNKNOWN_GLYPH;
+        glyphs[y_max][i] = UNKNOWN_GLYPH;
+    }
+    for(i = y_min; i <= y_max; i++) {
+        glyphs[i][x_min] = UNKNOWN_GLYPH;
+        glyphs[i][x_max] = UNKNOWN_GLYPH;
+    }
+    Screen_Invalidate();
+}
+
+void Screen_Invalidate(void) {
+    cursorKnown = 0;
+    shownColor = NO_COLOR;
+}
+
+void Screen_SetColor(enum term_color color) {
+    if(color >= BackgroundBlack) penBg = color;
+    else penFg = color;
+}
+
+void Screen_CharXY(char c, uint8_t x, uint8_t y) {
+    uint8_t color = PACK_COLOR(penFg, penBg);
+    if(x >= SCREEN_WIDTH || y >= SCREEN_HEIGHT) return;
+    if(glyphs[y][x] == (uint8_t)c && colors[y][x] == color) return; // already shown
+    if(IS_DIRTY(x, y)) stats.dropped++; // the previous value never made it to the terminal
+    glyphs[y][x] = c;
+    colors[y][x] = color;
+    dirty[y][x >> 3] |= 1 << (x & 7);
+    dirtyRows |= (uint32_t)1 << y;
+}
+
+uint8_t Screen_Text(uint8_t x, uint8_t y, const char * str) {
+    const char * c;
+    for(c = str; *c && x < SCREEN_WIDTH; c++, x++) Screen_CharXY(*c, x, y);
+    return c - str;
+}
+
+uint8_t Screen_Unsigned(uint8_t x, uint8_t y, uint16_t n) {
+    uint8_t digits = 1, i;
+    uint16_t rest;
+    for(rest = n / 10; rest; rest /= 10) digits++;
+    // fill in from the last digit back
+    for(i = digits; i > 0; i--) {
+        Screen_CharXY('0' + n % 10, x + i - 1, y);
+        n /= 10;
+    }
+    return digits;
+}
+
+uint8_t Screen_Signed(uint8_t x, uint8_t y, int16_t n) {
+    if(n >= 0) return Screen_Unsigned(x, y, n);
+    Screen_CharXY('-', x, y);
+    return Screen_Unsigned(x + 1, y, -(int32_t)n) + 1;
+}
+
+void Screen_ScrollLeft(uint8_t x_min, uint8_t y_min, uint8_t x_max, uint8_t y_max) {
+    uint8_t y;
+    uint16_t redraw = 0, scrolled = 0;
+    if(scrollMode == SCREEN_SCROLL_REDRAW || outputMode == SCREEN_OUTPUT_BINARY) {
+        keptCount = 0;
+        return;
+    }
+    // the terminal can only move what it already shows, the scroll goes out in the same frame
+    SendCells();
+    RefillBudget();
+    if(scrollMode == SCREEN_SCROLL_MARGINS) {
+        for(y = y_min; y <= y_max; y++) {
+            if(RowDirty(x_min, x_max, y)) break;
+            redraw += RedrawCost(x_min, x_max, y, 0);
+            scrolled += RedrawCost(x_min, x_max, y, 1);
+        }
+        if(y > y_max && redraw > MARGIN_SCROLL_COST + ColorCost(shownColor, DEFAULT_COLOR) + scrolled &&
+           ScrollFits(MAX_MARGIN_COST)) {
+            OpenFrame();
+            SetColor(DEFAULT_COLOR); // blanks scrolled in take the current color
+            EmitString("\x1B[?69h"); // allow left/right margins
+            EmitPair(y_min + 1, y_max + 1, 'r');
+            EmitPair(x_min + 1, x_max + 1, 's');
+            EmitString("\x1B[ @"); // scroll left
+            EmitString("\x1B[?69l\x1B[r"); // leaving margin mode also clears the left/right margins
+            cursorKnown = 0; // setting the margins homes the cursor
+            for(y = y_min; y <= y_max; y++) ShiftRow(x_min, x_max, y);
+            keptCount = 0;
+            Drain();
+            return;
+        }
+    }
+    for(y = y_min; y <= y_max; y++) {
+        // sparse rows are cheaper to redraw than to scroll, rows over budget are redrawn once there is room
+        if(scrollMode == SCREEN_SCROLL_DCH && !RowDirty(x_min, x_max, y) &&
+           RedrawCost(x_min, x_max, y, 0) > ColorCost(shownColor, DEFAULT_COLOR) + PositionCost(x_min, y) +
+           DCH_SCROLL_COST + (x_max > x_min ? CsiCost(x_max - x_min) : 0) + RedrawCost(x_min, x_max, y, 1) &&
+           ScrollFits(MAX_DCH_COST)) {
+            // delete pulls in everything up to the edge of the screen so insert a blank to push the border back out
+            OpenFrame();
+            SetColor(DEFAULT_COLOR);
+            MoveCursor(x_min, y, shownColor);
+            EmitCsi(1, 'P');
+            if(x_max > x_min) EmitCsi(x_max - x_min, 'C');
+            EmitCsi(1, '@');
+            cursorX = x_max;
+            ShiftRow(x_min, x_max, y);
+        }
+    }
+    keptCount = 0;
+    Drain();
+}
+
+void Screen_Keep(uint8_t x, uint8_t y) {
+    if(keptCount == SCREEN_KEEP_LENGTH) return; // the estimate just gets worse
+    keptX[keptCount] = x;
+    keptY[keptCount] = y;
+    keptCount++;
+}
+
+void Screen_SetScrollMode(uint8_t mode) {
+    scrollMode = mode;
+}
+
+void Screen_SetBackpressure(uint8_t mode) {
+    backpressure = mode;
+}
+
+void Screen_SetOutputMode(uint8_t mode) {
+    outputMode = mode;
+    // the client moves the cursor and changes colors on its own
+    cursorKnown = 0;
+    shownColor = NO_COLOR;
+}
+
+void Screen_SetSyncUpdate(uint8_t enable) {
+    syncUpdate = enable;
+}
+
+uint16_t Screen_Flush(void) {
+    uint16_t size;
+    SendCells();
+    size = CloseFrame();
+    Drain();
+    return size;
+}
+
+/** @brief Send as many dirty cells as the budget allows
+ *
+ * Cells that do not fit stay dirty and a retry is scheduled for them. The
+ * frame is left open so more output can join it before Screen_Flush closes it.
+ */
+void SendCells(void) {
+    uint8_t x, y, color, next, tier;
+    uint8_t rowLeft, run;
+    uint8_t reserve = SYNC_ON ? SYNC_END_COST : 0; // room to close the frame
+    int32_t needed = MAX_CELL_COST + reserve; // budget left before each cell
+    uint16_t cost;
+    if(dirtyRows == 0) return;
+    RefillBudget();
+    if(backpressure == SCREEN_BACKPRESSURE_BLOCK) needed = INT32_MIN; // let the UART wait for room
+    else if(backpressure == SCREEN_BACKPRESSURE_DROP && !frameOpen) {
+        cost = FrameCost() + reserve;
+        // a frame larger than the whole buffer would never fit, it goes out in parts like when coalescing
+        if(cost > budget && cost <= SCREEN_TX_BUFFER_LENGTH) {
+            stats.droppedFrames++; // all of it goes with the next frame that fits
+            HoldBack();
+            return;
+        }
+    }
+    if(outputMode == SCREEN_OUTPUT_BINARY) {
+        SendBinary();
+        return;
+    }
+    for(tier = 0; tier < TIER_COUNT; tier++) {
+        // start with whatever color the terminal already has so a frame in a single color needs no switch at all
+        color = shownColor;
+        do {
+            next = NO_COLOR;
+            for(y = 0; y < SCREEN_HEIGHT; y++) {
+                if(!(dirtyRows & ((uint32_t)1 << y))) continue;
+                rowLeft = 0;
+                for(x = 0; x < SCREEN_WIDTH; x++) {
+                    if(!IS_DIRTY(x, y)) continue;
+                    if(CellTier(x, y) != tier || budget < needed) { // leave it for a later tier or flush
+                        rowLeft = 1;
+                        continue;
+                    }
+                    if(color == NO_COLOR) color = colors[y][x];
+                    if(colors[y][x] != color) { // leave it for a later pass
+                        if(next == NO_COLOR) next = colors[y][x];
+                        rowLeft = 1;
+                        continue;
+                    }
+                    OpenFrame();
+                    SetColor(color);
+                    MoveCursor(x, y, color);
+                    run = BlankRun(x, y, color);
+                    if(run) { // erase the blanks in one go, the cursor stays put
+                        if(x + run == SCREEN_WIDTH) EmitString("\x1B[K");
+                        else EmitCsi(run, 'X');
+                        for(; run > 1; run--, x++) dirty[y][x >> 3] &= ~(1 << (x & 7));
+                        dirty[y][x >> 3] &= ~(1 << (x & 7));
+                        continue;
+                    }
+                    Emit(glyphs[y][x]);
+                    dirty[y][x >> 3] &= ~(1 << (x & 7));
+                    // the cursor position is unreliable once it reaches the last column
+                    if(++cursorX >= SCREEN_WIDTH) cursorKnown = 0;
+                }
+                if(!rowLeft) dirtyRows &= ~((uint32_t)1 << y);
+            }
+            color = next;
+        } while(color != NO_COLOR);
+    }
+    if(dirtyRows) HoldBack();
+}
+
+/** @brief Send dirty rows as a binary frame, see screen_protocol.h
+ *
+ * Whole rows are sent from the top for as long as they fit in the budget.
+ */
+void SendBinary(void) {
+    uint8_t x, y, group, groups;
+    uint8_t color = SCREEN_PROTOCOL_DEFAULT_COLOR;
+    uint32_t rows = 0;
+    int32_t used = BINARY_START_COST;
+    uint16_t cost;
+    for(y = 0; y < SCREEN_HEIGHT; y++) {
+        if(!(dirtyRows & ((uint32_t)1 << y))) continue;
+        cost = 1;
+        for(group = 0; group < DIRTY_BYTES; group++) {
+            if(dirty[y][group]) cost++;
+        }
+        for(x = 0; x < SCREEN_WIDTH; x++) if(IS_DIRTY(x, y)) cost += 2; // glyph and color at most
+        // the first row always goes if the buffer is empty so a large row cannot hold things up forever
+        if(backpressure != SCREEN_BACKPRESSURE_BLOCK && used + cost > budget &&
+           (rows || budget < SCREEN_TX_BUFFER_LENGTH)) break;
+        rows |= (uint32_t)1 << y;
+        used += cost;
+    }
+    if(rows) {
+        OpenFrame();
+        Emit(SCREEN_PROTOCOL_START_0);
+        Emit(SCREEN_PROTOCOL_START_1);
+        groups = 0;
+        for(group = 0; group < SCREEN_PROTOCOL_ROW_GROUPS; group++) {
+            if((rows >> (8 * group)) & 0xFF) groups |= 1 << group;
+        }
+        Emit(groups);
+        for(group = 0; group < SCREEN_PROTOCOL_ROW_GROUPS; group++) {
+            if(groups & (1 << group)) Emit(rows >> (8 * group));
+        }
+        for(y = 0; y < SCREEN_HEIGHT; y++) {
+            if(!(rows & ((uint32_t)1 << y))) continue;
+            groups = 0;
+            for(group = 0; group < DIRTY_BYTES; group++) {
+                if(dirty[y][group]) groups |= 1 << group;
+            }
+            Emit(groups);
+            for(group = 0; group < DIRTY_BYTES; group++) {
+                if(dirty[y][group]) Emit(dirty[y][group]);
+            }
+            for(x = 0; x < SCREEN_WIDTH; x++) {
+                if(!IS_DIRTY(x, y)) continue;
+                if(colors[y][x] != color) {
+                    color = colors[y][x];
+                    Emit(glyphs[y][x] | SCREEN_PROTOCOL_COLOR_FLAG);
+                    Emit(color);
+                }
+                else Emit(glyphs[y][x]);
+            }
+            for(group = 0; group < DIRTY_BYTES; group++) dirty[y][group] = 0;
+            dirtyRows &= ~((uint32_t)1 << y);
+        }
+        // plain output that follows has no idea what the client did to the terminal
+        cursorKnown = 0;
+        shownColor = NO_COLOR;
+    }
+    if(dirtyRows) HoldBack();
+}
+
+/** @brief Count the cells that did not fit and come back for them once the UART has caught up
+ */
+void HoldBack(void) {
+    uint8_t x, y;
+    uint16_t pending = 0;
+    for(y = 0; y < SCREEN_HEIGHT; y++) {
+        if(!(dirtyRows & ((uint32_t)1 << y))) continue;
+        for(x = 0; x < SCREEN_WIDTH; x++) if(IS_DIRTY(x, y)) pending++;
+    }
+    stats.deferred += pending;
+    if(pending > stats.maxPending) stats.maxPending = pending;
+    if(retry == TASK_NO_HANDLE) retry = Task_ScheduleHandle(RetryFlush, 0, RETRY_DELAY, 0);
+}
+
+/** @brief Estimate the bytes needed to send every dirty cell
+ */
+uint16_t FrameCost(void) {
+    uint8_t x, y;
+    uint16_t cells = 0;
+    for(y = 0; y < SCREEN_HEIGHT; y++) {
+        if(!(dirtyRows & ((uint32_t)1 << y))) continue;
+        for(x = 0; x < SCREEN_WIDTH; x++) if(IS_DIRTY(x, y)) cells++;
+    }
+    return cells * REDRAW_CELL_COST;
+}
+
+void Screen_LinkTest(screen_link_t * result) {
+    char line[LINK_LINE_LENGTH];
+    uint8_t i;
+    tint_t start, wait, waited = 0, elapsed;
+    Drain();
+    // carriage return, a row of digits and letters, then erase it again
+    line[0] = '\r';
+    for(i = 1; i < LINK_LINE_LENGTH - 4; i++) line[i] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ"[i % 36];
+    line[i++] = '\r';
+    line[i++] = '\x1B';
+    line[i++] = '[';
+    line[i] = 'K';
+    start = TimeNow();
+    while(UART_IsTransmitting(SUBSYSTEM_UART) && TimeSince(start) < LINK_TIMEOUT); // start from an empty buffer
+    start = TimeNow();
+    for(i = 0; i < LINK_LINES; i++) {
+        UART_Write(SUBSYSTEM_UART, line, LINK_LINE_LENGTH);
+        // the buffer is filled and then waited on until it is empty, so UART_Write never has to wait for room
+        if((i + 1) % LINK_FILL_LINES && i + 1 < LINK_LINES) continue;
+        wait = TimeNow();
+        while(UART_IsTransmitting(SUBSYSTEM_UART) && TimeSince(start) < LINK_TIMEOUT);
+        waited += TimeSince(wait);
+    }
+    elapsed = TimeSince(start);
+    if(elapsed == 0) elapsed = 1;
+    if(waited == 0) waited = 1;
+    result->bytes = (uint16_t)LINK_LINE_LENGTH * LINK_LINES;
+    result->stall = waited;
+    result->bytesPerSecond = result->bytes * 1000UL / elapsed;
+    result->drainRate = result->bytes * 1000UL / waited;
+    linkRate = result->bytesPerSecond;
+    cursorKnown = 0;
+    budget = SCREEN_TX_BUFFER_LENGTH;
+    budgetTime = TimeNow();
+}
+
+void Screen_SetStatusRows(uint8_t y) {
+    statusRow = y;
+}
+
+void Screen_SetFocus(uint8_t x) {
+    focusX = x;
+}
+
+void Screen_GetStats(screen_stats_t * s) {
+    *s = stats;
+}
+
+void Screen_ResetStats(void) {
+    screen_stats_t empty = {0};
+    stats = empty;
+}
+
+uint16_t Screen_FramePercentile(uint8_t percent) {
+    uint32_t wanted = (stats.frames * percent + 99) / 100; // frames that have to fit
+    uint32_t counted = 0;
+    uint8_t bin;
+    for(bin = 0; bin < SCREEN_SIZE_BINS - 1; bin++) {
+        counted += stats.frameSizes[bin];
+        if(counted >= wanted) break;
+    }
+    // bin 0 only holds empty frames, bin n starts at 2^(n-1)
+    return bin ? (uint16_t)1 << (bin - 1) : 0;
+}
+
+void Screen_FlushAll(void) {
+    uint8_t mode;
+    Task_Cancel(retry);
+    retry = TASK_NO_HANDLE;
+    // allowed to wait on the UART this one time, which is just what blocking backpressure does
+    mode = backpressure;
+    backpressure = SCREEN_BACKPRESSURE_BLOCK;
+    Screen_Flush();
+    backpressure = mode;
+}
+
+void Screen_RestoreColor(void) {
+    SetColor(DEFAULT_COLOR);
+    Drain();
+}
+
+/** @brief Start a frame before the first byte of it is sent
+ */
+void OpenFrame(void) {
+    if(frameOpen) return;
+    frameOpen = 1;
+    frameStart = stats.bytes;
+    if(SYNC_ON) EmitString("\x1B[?2026h"); // terminal holds off drawing until the frame is done
+}
+
+/** @brief End the frame and record how long it takes to leave the UART
+ *
+ * Whatever is still queued when the frame closes has to drain before the
+ * terminal has all of it, which is the latency of the frame.
+ *
+ * @return number of bytes in the frame
+ */
+uint16_t CloseFrame(void) {
+    int32_t queued;
+    uint16_t latency, size;
+    uint8_t bin;
+    if(!frameOpen) return 0;
+    if(SYNC_ON) EmitString("\x1B[?2026l");
+    frameOpen = 0;
+    stats.frames++;
+    size = stats.bytes - frameStart;
+    if(size > stats.maxFrameBytes) stats.maxFrameBytes = size;
+    for(bin = 0; bin < SCREEN_SIZE_BINS - 1 && size >> bin; bin++);
+    stats.frameSizes[bin]++;
+    queued = SCREEN_TX_BUFFER_LENGTH - budget;
+    if(queued > (int32_t)stats.highWater) stats.highWater = queued > UINT16_MAX ? UINT16_MAX : queued;
+    if(budget < 0) stats.stalls++; // the UART had to make room before the frame was done
+    if(queued < 0) queued = 0;
+    if(queued > SCREEN_TX_BUFFER_LENGTH) queued = SCREEN_TX_BUFFER_LENGTH;
+    latency = queued * 1000000UL / linkRate;
+    if(stats.frames == 1 || latency < stats.minLatency) stats.minLatency = latency;
+    if(latency > stats.maxLatency) stats.maxLatency = latency;
+    return size;
+}
+
+/** @brief Pick which tier a dirty cell is sent in
+ *
+ * @param x column of the cell
+ * @param y row of the cell
+ */
+uint8_t CellTier(uint8_t x, uint8_t y) {
+    if(y >= statusRow) return TIER_STATUS;
+    if(x > focusX + SCREEN_NEAR_FIELD || x + SCREEN_NEAR_FIELD < focusX) return TIER_FAR;
+    return TIER_NEAR;
+}
+
+/** @brief Add the bytes the UART sent since the last flush to the budget
+ *
+ * The budget can never be more than the transmit buffer holds. Once the UART
+ * has gone idle the whole buffer is known to be free.
+ */
+void RefillBudget(void) {
+    tint_t elapsed = TimeSince(budgetTime);
+    budgetTime = TimeNow();
+    if(!UART_IsTransmitting(SUBSYSTEM_UART)) budget = SCREEN_TX_BUFFER_LENGTH;
+    else {
+        if(elapsed > 1000) elapsed = 1000; // plenty to fill the buffer and keeps the math in range
+        budget += elapsed * linkRate / 1000;
+        if(budget > SCREEN_TX_BUFFER_LENGTH) budget = SCREEN_TX_BUFFER_LENGTH;
+    }
+}
+
+/** @brief Flush again for the cells that were over budget last time
+ */
+void RetryFlush(void) {
+    retry = TASK_NO_HANDLE;
+    Screen_Flush();
+}
+
+/** @brief Check the budget has room for a scroll and for closing the frame after it
+ *
+ * @param cost bytes the scroll sequence takes at most
+ */
+uint8_t ScrollFits(uint8_t cost) {
+    int32_t needed = cost;
+    if(backpressure == SCREEN_BACKPRESSURE_BLOCK) return 1; // the UART waits for room
+    if(SYNC_ON) needed += SYNC_END_COST + (frameOpen ? 0 : SYNC_START_COST);
+    return budget >= needed;
+}
+
+/** @brief Check if part of a row still has cells waiting to be sent
+ *
+ * @param x_min first cell to check
+ * @param x_max last cell to check
+ * @param y row to check
+ */
+uint8_t RowDirty(uint8_t x_min, uint8_t x_max, uint8_t y) {
+    if(!(dirtyRows & ((uint32_t)1 << y))) return 0;
+    for(; x_min <= x_max; x_min++) if(IS_DIRTY(x_min, y)) return 1;
+    return 0;
+}
+
+/** @brief Find out if a run of blanks starting at a cell is cheaper to erase than to print
+ *
+ * The run covers every blank in the same color from the cell on, dirty or
+ * not, up to the last dirty one. Erasing leaves the cursor at the start so
+ * it has to pay for the move past the run as well, unless the run reaches
+ * the end of the line.
+ *
+ * @param x first cell of the run, must be dirty
+ * @param y row of the run
+ * @param color color the terminal is printing with
+ * @return number of cells to erase or 0 to print them instead
+ */
+uint8_t BlankRun(uint8_t x, uint8_t y, uint8_t color) {
+    uint8_t end, last = x;
+    if(glyphs[y][x] != ' ') return 0;
+    for(end = x; end < SCREEN_WIDTH && glyphs[y][end] == ' ' && colors[y][end] == color; end++) {
+        if(IS_DIRTY(end, y)) last = end;
+    }
+    if(end == SCREEN_WIDTH && last - x + 1 > ERASE_LINE_COST) return SCREEN_WIDTH - x;
+    if(last - x + 1 > 2 * CsiCost(last - x + 1)) return last - x + 1;
+    return 0;
+}
+
+/** @brief Estimate the bytes needed to show a row the way the caller draws it after a scroll
+ *
+ * Follows what SendCells does with the cells that differ: a cursor position
+ * for the first one, the cheapest move to each one after it, a color change
+ * where the color differs and erasing runs of blanks.
+ *
+ * @param x_min first cell of the row to shift
+ * @param x_max last cell of the row to shift
+ * @param y row to shift, must not have dirty cells
+ * @param scrolled estimate after the terminal moved the row, otherwise for the row as it is shown
+ */
+uint16_t RedrawCost(uint8_t x_min, uint8_t x_max, uint8_t y, uint8_t scrolled) {
+    uint64_t kept = KeptCells(y);
+    uint8_t x, end, last, changed, glyph, cellColor, color = shownColor, cursor = 0, placed = 0;
+    uint16_t cost = 0;
+    for(x = x_min; x <= x_max; x++) {
+        if(!ScrolledCell(x, x_max, y, kept, scrolled, &glyph, &cellColor)) continue;
+        cost += placed ? HorizontalCost(cursor, x, y, color) : PositionCost(x, y);
+        placed = 1;
+        cost += ColorCost(color, cellColor);
+        color = cellColor;
+        if(glyph == ' ') { // same rule as BlankRun
+            for(last = end = x; end <= x_max; end++) {
+                changed = ScrolledCell(end, x_max, y, kept, scrolled, &glyph, &cellColor);
+                if(glyph != ' ' || cellColor != color) break;
+                if(changed) last = end;
+            }
+            if(last - x + 1 > 2 * CsiCost(last - x + 1)) {
+                cost += CsiCost(last - x + 1);
+                cursor = x; // erasing leaves the cursor where it is
+                x = last;
+                continue;
+            }
+        }
+        cost++;
+        cursor = x + 1;
+    }
+    return cost;
+}
+
+/** @brief Find what the caller draws in a cell of a row it scrolls and if the terminal has to be sent it
+ *
+ * Kept cells are drawn the same again, whatever they cover is taken to be
+ * blank. Everything else is drawn as it was one cell further right.
+ *
+ * @param x cell to look at
+ * @param x_max last cell of the row to shift
+ * @param y row to shift
+ * @param kept one bit for every cell of the row that stays put
+ * @param scrolled compare with the row after the terminal moved it, otherwise with the row as it is shown
+ * @param glyph set to the glyph the caller draws
+ * @param color set to the color the caller draws with
+ * @return non zero if the terminal does not already show that
+ */
+uint8_t ScrolledCell(uint8_t x, uint8_t x_max, uint8_t y, uint64_t kept, uint8_t scrolled, uint8_t * glyph,
+                     uint8_t * color) {
+    uint8_t from = scrolled ? x + 1 : x; // cell the terminal shows in its place
+    if(kept & CELL_BIT(x)) {
+        *glyph = glyphs[y][x];
+        *color = colors[y][x];
+    }
+    else if(x < x_max && !(kept & CELL_BIT(x + 1))) {
+        *glyph = glyphs[y][x + 1];
+        *color = colors[y][x + 1];
+    }
+    else {
+        *glyph = ' ';
+        *color = DEFAULT_COLOR;
+    }
+    // the insert after the delete leaves a blank in the last cell
+    if(from > x_max) return *glyph != ' ' || *color != DEFAULT_COLOR;
+    return *glyph != glyphs[y][from] || *color != colors[y][from];
+}
+
+/** @brief Collect the cells of a row that stay put over the scroll
+ *
+ * @return one bit for every kept cell of the row
+ */
+uint64_t KeptCells(uint8_t y) {
+    uint64_t cells = 0;
+    uint8_t i;
+    for(i = 0; i < keptCount; i++) {
+        if(keptY[i] == y) cells |= CELL_BIT(keptX[i]);
+    }
+    return cells;
+}
+
+/** @brief Bytes needed to put the cursor on a cell without knowing where it is
+ */
+uint8_t PositionCost(uint8_t x, uint8_t y) {
+    // the column defaults to 1 when left out
+    return x == 0 ? CsiCost(y + 1) : 4 + Digits(y + 1) + Digits(x + 1);
+}
+
+/** @brief Shift the framebuffer contents of a row one cell to the left
+ *
+ * Used after the terminal has moved the row itself so nothing is marked dirty.
+ *
+ * @param x_min first cell of the row to shift
+ * @param x_max last cell of the row to shift, it becomes blank
+ * @param y row to shift
+ */
+void ShiftRow(uint8_t x_min, uint8_t x_max, uint8_t y) {
+    uint8_t x;
+    for(x = x_min; x < x_max; x++) {
+        glyphs[y][x] = glyphs[y][x + 1];
+        colors[y][x] = colors[y][x + 1];
+    }
+    glyphs[y][x_max] = ' ';
+    colors[y][x_max] = DEFAULT_COLOR;
+}
+
+/** @brief Send a byte to the terminal
+ *
+ * The byte is staged and goes to the UART with the rest of the span.
+ *
+ * @param c byte to send
+ */
+void Emit(char c) {
+    stage[staged++] = c;
+    if(staged == STAGE_LENGTH) Drain();
+    budget--;
+    stats.bytes++;
+}
+
+/** @brief Hand the staged bytes to the UART in a single write
+ */
+void Drain(void) {
+    if(staged == 0) return;
+    UART_Write(SUBSYSTEM_UART, stage, staged);
+    staged = 0;
+}
+
+/** @brief Send a null terminated string to the terminal
+ *
+ * @param str string to send
+ */
+void EmitString(const char * str) {
+    while(*str) Emit(*str++);
+}
+
+/** @brief Send a number as decimal text
+ *
+ * @param n number to send
+ */
+void EmitNumber(uint8_t n) {
+    if(n >= 100) Emit('0' + n / 100);
+    if(n >= 10) Emit('0' + (n / 10) % 10);
+    Emit('0' + n % 10);
+}
+
+/** @brief Send a control sequence with a single count parameter
+ *
+ * A count of 1 is the default for every sequence used here so it is left out.
+ *
+ * @param n count parameter
+ * @param command final character of the sequence
+ */
+void EmitCsi(uint8_t n, char command) {
+    Emit('\x1B');
+    Emit('[');
+    if(n != 1) EmitNumber(n);
+    Emit(command);
+}
+
+/** @brief Send a control sequence with two parameters
+ *
+ * @param a first parameter
+ * @param b second parameter
+ * @param command final character of the sequence
+ */
+void EmitPair(uint8_t a, uint8_t b, char command) {
+    Emit('\x1B');
+    Emit('[');
+    EmitNumber(a);
+    Emit(';');
+    EmitNumber(b);
+    Emit(command);
+}
+
+/** @brief Number of decimal digits needed to send a number
+ */
+uint8_t Digits(uint8_t n) {
+    if(n >= 100) return 3;
+    if(n >= 10) return 2;
+    return 1;
+}
+
+/** @brief Bytes needed by EmitCsi for a count
+ */
+uint8_t CsiCost(uint8_t n) {
+    return n == 1 ? 3 : 3 + Digits(n);
+}
+
+/** @brief Check if the cursor can be advanced by printing the cells it passes over
+ *
+ * This only works when every cell in between is already shown by the terminal
+ * in the color that is currently active.
+ *
+ * @param from first cell to reprint
+ * @param to cell after the last one to reprint
+ * @param y row of the cells
+ * @param color color that is currently active on the terminal
+ */
+uint8_t CanReprint(uint8_t from, uint8_t to, uint8_t y, uint8_t color) {
+    for(; from < to; from++) {
+        if(IS_DIRTY(from, y) || colors[y][from] != color || glyphs[y][from] == UNKNOWN_GLYPH) return 0;
+    }
+    return 1;
+}
+
+/** @brief Bytes SetColor sends to change from one color to another
+ */
+uint8_t ColorCost(uint8_t from, uint8_t to) {
+    if(from == to) return 0;
+    if(from == NO_COLOR || ((from ^ to) & 0xF0 && (from ^ to) & 0x0F)) return sizeof(sgrPair) - 1;
+    return sizeof(sgrSingle) - 1;
+}
+
+/** @brief Bytes needed to move the cursor along a row
+ */
+uint8_t HorizontalCost(uint8_t from, uint8_t to, uint8_t y, uint8_t color) {
+    uint8_t n, cost;
+    if(to == from) return 0;
+    if(to < from) { // backspaces or cursor back
+        n = from - to;
+        cost = CsiCost(n);
+        return n < cost ? n : cost;
+    }
+    n = to - from;
+    cost = CsiCost(n);
+    if(n < cost && CanReprint(from, to, y, color)) return n;
+    return cost;
+}
+
+/** @brief Move the cursor along a row using the sequence HorizontalCost picked
+ */
+void MoveHorizontal(uint8_t from, uint8_t to, uint8_t y, uint8_t color) {
+    uint8_t n;
+    if(to == from) return;
+    if(to < from) {
+        n = from - to;
+        if(n < CsiCost(n)) while(n--) Emit('\b');
+        else EmitCsi(n, 'D');
+        return;
+    }
+    n = to - from;
+    if(n < CsiCost(n) && CanReprint(from, to, y, color)) {
+        for(; from < to; from++) Emit(glyphs[y][from]);
+    }
+    else EmitCsi(n, 'C');
+}
+
+/** @brief Move the terminal cursor to a cell using the fewest bytes
+ *
+ * @param x column to move to
+ * @param y row to move to
+ * @param color color that is currently active on the terminal
+ */
+void MoveCursor(uint8_t x, uint8_t y, uint8_t color) {
+    uint8_t best, cost, vertical = 0, method = MOVE_ABSOLUTE;
+    if(cursorKnown && cursorX == x && cursorY == y) return;
+    best = PositionCost(x, y);
+    if(cursorKnown) {
+        if(y > cursorY) { // line feeds or cursor down
+            vertical = y - cursorY;
+            if(CsiCost(vertical) < vertical) vertical = CsiCost(vertical);
+        }
+        else if(y < cursorY) vertical = CsiCost(cursorY - y); // cursor up
+        cost = vertical + HorizontalCost(cursorX, x, y, color);
+        if(cost < best) {
+            best = cost;
+            method = MOVE_RELATIVE;
+        }
+        cost = vertical + 1 + HorizontalCost(0, x, y, color); // carriage return first
+        if(cost < best) method = MOVE_RETURN;
+    }
+    if(method == MOVE_ABSOLUTE) {
+        if(x != 0) EmitPair(y + 1, x + 1, 'H');
+        else EmitCsi(y + 1, 'H');
+    }
+    else {
+        if(y > cursorY) {
+            if(y - cursorY <= CsiCost(y - cursorY)) while(cursorY++ < y) Emit('\n');
+            else EmitCsi(y - cursorY, 'B');
+        }
+        else if(y < cursorY) EmitCsi(cursorY - y, 'A');
+        if(method == MOVE_RETURN) {
+            Emit('\r');
+            cursorX = 0;
+        }
+        MoveHorizontal(cursorX, x, y, color);
+    }
+    cursorX = x;
+    cursorY = y;
+    cursorKnown = 1;
+}
+
+/** @brief Switch the terminal to a color unless it is already using it
+ *
+ * @param color packed color to switch to
+ */
+void SetColor(uint8_t color) {
+    uint8_t fg = COLOR_FG(color), bg = COLOR_BG(color);
+    if(color == shownColor) return;
+    if(shownColor == NO_COLOR || ((color ^ shownColor) & 0xF0 && (color ^ shownColor) & 0x0F)) {
+        sgrPair[3] = '0' + fg % 10;
+        sgrPair[6] = '0' + bg % 10;
+        EmitString(sgrPair);
+    }
+    else {
+        sgrSingle[2] = (color ^ shownColor) & 0xF0 ? '3' : '4';
+        sgrSingle[3] = '0' + ((color ^ shownColor) & 0xF0 ? fg : bg) % 10;
+        EmitString(sgrSingle);
+    }
+    shownColor = color;
+}
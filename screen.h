@@ -0,0 +1,310 @@
+/**
+ * @{
+ * @file screen.h
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Shadow framebuffer for the game terminal
+ *
+ * The game draws into an off-screen copy of the terminal (glyph and color
+ * for every cell) instead of writing to the UART directly. Screen_Flush()
+ * then sends only the cells that changed since the last flush.
+ */
+
+#ifndef SCREEN_H_
+#define SCREEN_H_
+
+#include "project_settings.h"
+#include "terminal.h"
+
+#define SCREEN_WIDTH                60              // Width of the terminal window
+#define SCREEN_HEIGHT               25              // Height of the terminal window
+
+// Ways Screen_ScrollLeft() can move the terminal contents
+#define SCREEN_SCROLL_REDRAW        0               // redraw every cell that changed (works everywhere)
+#define SCREEN_SCROLL_DCH           1               // delete/insert character on each row (PuTTY, TeraTerm, xterm)
+#define SCREEN_SCROLL_MARGINS       2               // left/right margins and scroll left (xterm and compatibles)
+
+#ifndef SCREEN_SCROLL_MODE
+#define SCREEN_SCROLL_MODE          SCREEN_SCROLL_REDRAW
+#endif
+
+// Link used to pace the output, defaults to the game UART
+#ifndef SCREEN_BAUD
+#define SCREEN_BAUD                 GAME_UART_BAUD
+#endif
+#ifndef SCREEN_TX_BUFFER_LENGTH
+#define SCREEN_TX_BUFFER_LENGTH     UART0_TX_BUFFER_LENGTH
+#endif
+
+#define SCREEN_KEEP_LENGTH          16              // cells Screen_Keep() holds until the next scroll
+
+// Format Screen_Flush() sends frames in
+#define SCREEN_OUTPUT_ANSI          0               // terminal sequences, any terminal can show them
+#define SCREEN_OUTPUT_BINARY        1               // binary frames for the host client, see screen_protocol.h
+
+#ifndef SCREEN_OUTPUT_MODE
+#define SCREEN_OUTPUT_MODE          SCREEN_OUTPUT_ANSI
+#endif
+
+// What Screen_Flush() does when a frame does not fit in the UART transmit buffer
+#define SCREEN_BACKPRESSURE_COALESCE 0              // send what fits, the rest follows with only the latest value of each cell
+#define SCREEN_BACKPRESSURE_DROP    1               // hold the whole frame back and send it along with the next one that fits
+#define SCREEN_BACKPRESSURE_BLOCK   2               // send everything and wait for the UART, input handling waits too
+
+#ifndef SCREEN_BACKPRESSURE
+#define SCREEN_BACKPRESSURE         SCREEN_BACKPRESSURE_COALESCE
+#endif
+
+// Wrap each frame in a synchronized update (DEC mode 2026), terminals without it just ignore the sequence
+#ifndef SCREEN_SYNC_UPDATE
+#define SCREEN_SYNC_UPDATE          0
+#endif
+
+#define SCREEN_NEAR_FIELD           16              // columns either side of the focus point sent first
+#define SCREEN_SIZE_BINS            12              // frame size bins, the last one takes every frame of 1 KB or more
+#define SCREEN_SIZE_OPEN            (1U << (SCREEN_SIZE_BINS - 2)) // smallest frame in the last bin, it has no upper bound
+
+/// Link test results, see Screen_LinkTest()
+typedef struct {
+    uint16_t bytes; ///< bytes sent
+    uint16_t stall; ///< ms spent waiting for the UART to empty the transmit buffer
+    uint32_t bytesPerSecond; ///< bytes per second from the first byte until the UART went idle
+    uint32_t drainRate; ///< bytes per second the transmit buffer emptied at while it was waited on
+} screen_link_t;
+
+/// Output counters, see Screen_GetStats()
+typedef struct {
+    uint32_t bytes; ///< bytes sent to the terminal
+    uint32_t deferred; ///< cell updates held back for a later flush to stay within budget
+    uint32_t dropped; ///< cell updates replaced by a newer value before they were sent
+    uint32_t droppedFrames; ///< frames held back as a whole
+    uint32_t stalls; ///< frames that had to wait for room in the UART transmit buffer
+    uint16_t highWater; ///< most bytes queued for the UART at the end of a frame
+    uint16_t maxPending; ///< most cells held back at once
+    uint32_t frames; ///< frames sent
+    uint16_t maxFrameBytes; ///< bytes in the largest frame
+    uint16_t minLatency; ///< shortest time in us from the end of a frame until it has left the UART
+    uint16_t maxLatency; ///< longest time in us from the end of a frame until it has left the UART
+    uint16_t frameSizes[SCREEN_SIZE_BINS]; ///< frames by size, bin n counts frames of less than 2^n bytes not in a lower bin
+} screen_stats_t;
+
+/** Reset the framebuffer to a blank screen
+ *
+ * Must be called right after the terminal has been cleared so the
+ * framebuffer and the terminal agree on what is shown.
+ */
+void Screen_Init(void);
+
+/** Draw a box on the terminal
+ *
+ * The border is drawn by the game module so the framebuffer only records
+ * that those cells are not its own.
+ *
+ * @param x_min left column of the box
+ * @param y_min top row of the box
+ * @param x_max right column of the box
+ * @param y_max bottom row of the box
+ */
+void Screen_DrawRect(uint8_t x_min, uint8_t y_min, uint8_t x_max, uint8_t y_max);
+
+/** Forget what the terminal cursor and color are
+ *
+ * Call after writing to the terminal without going through the framebuffer,
+ * like positioning the cursor for text printed after the game. The next
+ * flush then starts with an absolute position and a full color change.
+ */
+void Screen_Invalidate(void);
+
+/** Set the color used by subsequent Screen_CharXY() and Screen_Text() calls
+ *
+ * Foreground and background are tracked separately just like the terminal.
+ *
+ * @param color foreground or background color
+ */
+void Screen_SetColor(enum term_color color);
+
+/** Draw a character into the framebuffer
+ *
+ * @param c character to draw
+ * @param x column of the cell
+ * @param y row of the cell
+ */
+void Screen_CharXY(char c, uint8_t x, uint8_t y);
+
+/** Draw a string into the framebuffer starting at a cell
+ *
+ * Text that runs past the right edge of the screen is clipped.
+ *
+ * @param x column of the first character
+ * @param y row of the text
+ * @param str string to draw
+ * @return number of characters drawn
+ */
+uint8_t Screen_Text(uint8_t x, uint8_t y, const char * str);
+
+/** Draw an unsigned number into the framebuffer without going through printf
+ *
+ * @param x column of the first digit
+ * @param y row of the number
+ * @param n number to draw
+ * @return number of characters drawn
+ */
+uint8_t Screen_Unsigned(uint8_t x, uint8_t y, uint16_t n);
+
+/** Draw a signed number into the framebuffer without going through printf
+ *
+ * @param x column of the sign or first digit
+ * @param y row of the number
+ * @param n number to draw
+ * @return number of characters drawn
+ */
+uint8_t Screen_Signed(uint8_t x, uint8_t y, int16_t n);
+
+/** Scroll part of the screen one column to the left
+ *
+ * The caller must draw every cell of the area again afterwards. Depending
+ * on the scroll mode the terminal is asked to move the contents itself so
+ * that redraw only sends the cells that really changed. Rows that are
+ * cheaper to redraw than to scroll, rows the budget has no room to scroll
+ * and every row in SCREEN_SCROLL_REDRAW mode are left for the redraw.
+ *
+ * @param x_min left column of the area
+ * @param y_min top row of the area
+ * @param x_max right column of the area
+ * @param y_max bottom row of the area
+ */
+void Screen_ScrollLeft(uint8_t x_min, uint8_t y_min, uint8_t x_max, uint8_t y_max);
+
+/** Mark a cell that stays put while the next Screen_ScrollLeft() moves the area under it
+ *
+ * A redraw leaves such a cell alone but after the terminal moved the row
+ * it has to be drawn again, the scroll weighs that in for up to
+ * SCREEN_KEEP_LENGTH cells marked since the last scroll. Whatever the cell
+ * covers is taken to be blank.
+ *
+ * @param x column of the cell
+ * @param y row of the cell
+ */
+void Screen_Keep(uint8_t x, uint8_t y);
+
+/** Select how Screen_ScrollLeft() moves the terminal contents
+ *
+ * Use SCREEN_SCROLL_REDRAW on terminals that do not support the
+ * delete/insert character or margin sequences.
+ *
+ * @param mode SCREEN_SCROLL_REDRAW, SCREEN_SCROLL_DCH or SCREEN_SCROLL_MARGINS
+ */
+void Screen_SetScrollMode(uint8_t mode);
+
+/** Send every cell that changed since the last flush to the terminal
+ *
+ * This commits the frame: everything sent since the previous flush,
+ * including any scrolling, goes out as a single burst and is wrapped in a
+ * synchronized update when enabled.
+ *
+ * Unless the backpressure mode is SCREEN_BACKPRESSURE_BLOCK, never sends
+ * more than the UART transmit buffer can take without blocking. Cells that
+ * do not fit stay dirty and are sent by a later flush, which is scheduled
+ * automatically.
+ *
+ * @return number of bytes in the frame
+ */
+uint16_t Screen_Flush(void);
+
+/** Send every cell that changed, even if that has to wait for the UART
+ *
+ * For the end of the game when nothing else is left to run and any cells
+ * still held back would otherwise be lost.
+ */
+void Screen_FlushAll(void);
+
+/** Select the format frames are sent in
+ *
+ * Binary frames need the host client (tools/screen_client.c) between the
+ * UART and the terminal. Scrolling is always left to the redraw and
+ * synchronized updates are not needed since the client draws a whole frame
+ * at once.
+ *
+ * @param mode SCREEN_OUTPUT_ANSI or SCREEN_OUTPUT_BINARY
+ */
+void Screen_SetOutputMode(uint8_t mode);
+
+/** Select what happens when a frame does not fit in the UART transmit buffer
+ *
+ * Only SCREEN_BACKPRESSURE_BLOCK lets a busy link hold up input handling.
+ *
+ * @param mode SCREEN_BACKPRESSURE_COALESCE, SCREEN_BACKPRESSURE_DROP or SCREEN_BACKPRESSURE_BLOCK
+ */
+void Screen_SetBackpressure(uint8_t mode);
+
+/** Turn wrapping each frame in a synchronized update on or off
+ *
+ * Costs 16 bytes per frame. Terminals that support DEC mode 2026 then never
+ * show a half drawn frame.
+ *
+ * @param enable 1 to wrap frames, 0 to send them as is
+ */
+void Screen_SetSyncUpdate(uint8_t enable);
+
+/** Measure what the UART link really delivers
+ *
+ * Prints a test pattern over the current line of the terminal and erases it
+ * again, taking around 100 ms at 460800 baud. The pattern is written a
+ * buffer full at a time and the UART is polled until it has sent it, so
+ * the time spent waiting is only what the link takes. The byte budget of every
+ * following flush is based on the measured rate instead of SCREEN_BAUD.
+ * Blocks until done so only use it between games.
+ *
+ * @param result where to put the measurements
+ */
+void Screen_LinkTest(screen_link_t * result);
+
+/** Mark where the status rows start
+ *
+ * Status rows are the first to be held back when a flush runs over budget.
+ *
+ * @param y first status row, rows below it are status rows too
+ */
+void Screen_SetStatusRows(uint8_t y);
+
+/** Set the column the player is looking at
+ *
+ * Cells more than SCREEN_NEAR_FIELD columns away are held back before the
+ * ones close to it when a flush runs over budget.
+ *
+ * @param x column to focus on
+ */
+void Screen_SetFocus(uint8_t x);
+
+/** Read the output counters
+ *
+ * @param s structure to copy the counters into
+ */
+void Screen_GetStats(screen_stats_t * s);
+
+/** Clear the output counters
+ */
+void Screen_ResetStats(void);
+
+/** Find the size bin a given share of frames stays within
+ *
+ * Frames are only counted by bin, so this is the smallest size in the bin
+ * the percentile falls in. A bin starting at n bytes holds frames of up to
+ * 2n - 1 bytes, except the one starting at SCREEN_SIZE_OPEN which takes
+ * everything larger too.
+ *
+ * @param percent share of frames, 50 for the median
+ * @return frame size in bytes the bin starts at
+ */
+uint16_t Screen_FramePercentile(uint8_t percent);
+
+/** Put the terminal back to the default color
+ *
+ * Call once the game is done drawing so text printed outside of the
+ * framebuffer does not pick up the last color used.
+ */
+void Screen_RestoreColor(void);
+
+/** @} */
+
+#endif /* SCREEN_H_ */
@@ -0,0 +1,54 @@
+/**
+ * @{
+ * @file screen_protocol.h
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Binary frame format shared by the firmware and the host client
+ *
+ * In binary output mode each frame is sent as:
+ * - SCREEN_PROTOCOL_START_0 and SCREEN_PROTOCOL_START_1
+ * - a byte with bit n set for each group of 8 rows with a change
+ * - for every group in that byte, from the top, a byte with bit n set for
+ *   row 8*group + n
+ * - for every row in those bytes, from the top:
+ *   - a byte with bit n set for each group of 8 columns with a change
+ *   - for every group in that byte, from the left, a byte with bit n set
+ *     for column 8*group + n
+ *   - for every column in those bytes, from the left, the glyph. If the
+ *     cell has a different color than the cell before it in the frame,
+ *     SCREEN_PROTOCOL_COLOR_FLAG is set in the glyph and the color follows.
+ *
+ * The first cell of a frame is compared against SCREEN_PROTOCOL_DEFAULT_COLOR.
+ * Colors are packed with the foreground index (0-7 for ForegroundBlack to
+ * ForegroundWhite) in the high nibble and the background index in the low
+ * nibble. Glyphs are 7 bit.
+ *
+ * Anything outside of a frame is plain terminal output and is passed on as
+ * is. The start sequence is an escape followed by a delete which no
+ * terminal sequence uses.
+ *
+ * This header is included by the host client too so it must not depend on
+ * anything from the firmware.
+ */
+
+#ifndef SCREEN_PROTOCOL_H_
+#define SCREEN_PROTOCOL_H_
+
+#define SCREEN_PROTOCOL_START_0         0x1B            // escape
+#define SCREEN_PROTOCOL_START_1         0x7F            // delete
+#define SCREEN_PROTOCOL_ROWS            25              // rows covered by the row groups
+#define SCREEN_PROTOCOL_COLUMNS         60              // columns covered by the column groups
+#define SCREEN_PROTOCOL_GROUP_WIDTH     8               // rows or columns in each group
+#define SCREEN_PROTOCOL_ROW_GROUPS      ((SCREEN_PROTOCOL_ROWS + SCREEN_PROTOCOL_GROUP_WIDTH - 1) / SCREEN_PROTOCOL_GROUP_WIDTH)
+#define SCREEN_PROTOCOL_COLUMN_GROUPS   ((SCREEN_PROTOCOL_COLUMNS + SCREEN_PROTOCOL_GROUP_WIDTH - 1) / SCREEN_PROTOCOL_GROUP_WIDTH)
+#define SCREEN_PROTOCOL_COLOR_FLAG      0x80            // glyph is followed by a color
+#define SCREEN_PROTOCOL_DEFAULT_COLOR   0x70            // white on black
+
+/// Foreground SGR code of a packed color
+#define SCREEN_PROTOCOL_FG(color)       (30 + ((color) >> 4))
+/// Background SGR code of a packed color
+#define SCREEN_PROTOCOL_BG(color)       (40 + ((color) & 0x0F))
+
+/** @} */
+
+#endif /* SCREEN_PROTOCOL_H_ */
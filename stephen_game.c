@@ -22,6 +22,42 @@
  * $game fly1 play
  * @endcode
  *
+ * By default the asteroid field is scrolled by redrawing the cells that changed. Terminals that support it can
+ * do the scrolling themselves which saves UART bandwidth on busy fields:
+ * - "$game fly1 scroll dch" uses delete/insert character on each row (PuTTY, TeraTerm, xterm)
+ * - "$game fly1 scroll margins" uses left/right margins and a single scroll sequence (xterm and compatibles)
+ * - "$game fly1 scroll redraw" goes back to the default
+ *
+ * By default the game never sends more than the UART can keep up with. When a frame does not fit, the status
+ * lines and the far side of the field catch up a moment later. "$game fly1 stats" shows how many bytes were
+ * sent and how many cell updates were held back or replaced before they were sent.
+ *
+ * "$game fly1 output binary" sends the screen as compact binary frames instead of terminal sequences. This
+ * needs the client in tools/screen_client.c running on the host between the serial port and the terminal.
+ * "$game fly1 output ansi" goes back to the default.
+ *
+ * "$game fly1 backpressure drop" holds back frames that do not fit as a whole and sends them along with the
+ * next one, "$game fly1 backpressure block" sends everything and lets the game wait for the UART (input waits
+ * too), "$game fly1 backpressure coalesce" goes back to the default. "$game fly1 stats" shows how often each
+ * happened.
+ *
+ * "$game fly1 sync on" wraps every frame in a synchronized update so terminals that support it never show a half
+ * drawn frame, "$game fly1 sync off" goes back to the default. "$game fly1 stats" also shows the number of
+ * frames, the largest one and the range of time frames spend in the UART.
+ *
+ * "$game fly1 bytes" shows the bytes sent for the asteroid field, shots, ship moves and status lines along with
+ * the median and 99th percentile frame size, "$game fly1 bytes reset" starts counting again. Play the same
+ * way with each scroll mode to compare them.
+ *
+ * "$game fly1 linktest" measures how many bytes per second the link to the terminal really delivers and paces
+ * the screen output to that from then on, run it between games.
+ *
+ * "$game fly1 bench" compares the milliseconds it takes to show a thousand numbers on the terminal through
+ * Game_Printf and through the direct path the game uses, UART time included, run it between games.
+ *
+ * tools/host builds the game for the PC against stand-ins for the library, "make -C tools/host test" checks every
+ * scroll and output mode ends up showing the same screen and "make -C tools/host report" compares the bytes they send.
+ *
  * @section prereq Dependencies
  * This project uses [embedded-software library](https://github.com/muhlbaier/embedded-software).
  * Please download and refer to library documentation to configure the project for your embedded platform.
@@ -49,22 +85,90 @@
 #include "game.h"
 #include "timing.h"
 #include "task.h"
+#include "task_handle.h"
 #include "terminal.h"
 #include "random_int.h"
+#include "screen.h"
 
+#ifndef MAP_WIDTH
 #define MAP_WIDTH                   60              // Width of the playable map
+#endif
+#ifndef MAP_HEIGHT
 #define MAP_HEIGHT                  18              // Height of the playable map
+#endif
 
 #define MAX_ASTEROIDS               250             // Maximum amount of asteroids that can appear on terminal
 #define MAX_ASTEROIDS_PER_COLUMN    MAP_HEIGHT-2    // Normalized play area
 #define MAX_COLUMNS                 MAP_WIDTH-2     // Normalized play area
 
+// Asteroid field, one bit per cell in a 64 bit word for each row (stored column c of a row is bit c)
+// The border rows and columns of the map are part of the field and always empty so nothing needs a bounds check
+#define FIELD_ROWS                  (MAP_HEIGHT+1)  // every row of the map including both borders
+#define FIELD_COLUMNS               64              // stored columns, bits in a row
+/// stored column holding column x of the map
+#define FIELD_COLUMN(x)             (((x) + fieldHead) & (FIELD_COLUMNS - 1))
+/// bit of column x of the map in a row of the field
+#define FIELD_BIT(x)                ((uint64_t)1 << FIELD_COLUMN(x))
+/// bit of column x of the map in a row of shots, shots do not scroll so there is no ring
+#define SHOT_BIT(x)                 ((uint64_t)1 << (x))
+
+#if FIELD_COLUMNS < MAP_WIDTH + 1
+#error "the field needs a spare column past the right border of the map"
+#endif
+#define NO_ASTEROID                 0
+#define SMALL_ASTEROID              1               // o type
+#define LARGE_ASTEROID              2               // O type
+
+#define GAME_TICK                   25              // Time (ms) between game ticks, every time below is a multiple of it
+/// game ticks in a time in ms
+#define TICKS(ms)                   ((ms) / GAME_TICK)
+#define SCROLL_DELAY                500             // Time (ms) before the asteroid field first moves
+#define DIFFICULTY_LEVELS           11              // Levels UpdateScore() steps through, see levelScores and scrollPeriods
+#define SCORE_PERIOD                2500            // Time (ms) the player has to stay alive for each point
 #define FIRE_SPEED                  100             // Speed (ms) at which player can fire a shot
 #define RECHARGE_RATE               750             // Speed (ms) at which weapon recharges
 #define MAX_SHOTS                   5               // Max number of shots that can appear on terminal simultanously
+#define SHOT_SPEED                  1               // Columns a shot moves every FIRE_SPEED ms
+
+#define MAX_EFFECTS                 8               // Hit flashes that can be shown at once
+#define EFFECT_TIME                 250             // Time (ms) a hit flash stays on screen
 
 // (1/asteroidSpawnChance) [e.g increasing spawn chance decreases spawn rate]
+#ifndef STARTING_DIFFICULTY
 #define STARTING_DIFFICULTY         24              // Default starting difficulty
+#endif
+
+// Status lines below the map, labels are drawn once and only the values after them are updated
+#define SCORE_ROW                   MAP_HEIGHT + 1
+#define SCORE_X                     7               // after "Score: "
+#define HEALTH_ROW                  MAP_HEIGHT + 2
+#define HEALTH_X                    8               // after "Health: "
+#define MAX_HEALTH                  3               // hearts shown
+#define CHARGE_ROW                  MAP_HEIGHT + 3
+#define CHARGE_X                    16              // after "Weapon Charge: ["
+#define MAX_CHARGE                  6               // segments in the charge bar
+#define DIFFICULTY_ROW              MAP_HEIGHT + 4
+#define DIFFICULTY_X                12              // after "Difficulty: "
+#define HUD_UNKNOWN                 0xFF            // value has not been drawn yet
+#define HUD_SCORE                   0x01            // score changed
+#define HUD_HEALTH                  0x02            // health changed
+#define HUD_CHARGE                  0x04            // weapon charge changed
+
+// Kinds of frames the byte report adds up separately
+#define FRAME_SHIFT                 0               // asteroid field moved
+#define FRAME_SHOT                  1               // shot fired or moved
+#define FRAME_MOVE                  2               // ship moved
+#define FRAME_STATUS                3               // status lines
+#define FRAME_EFFECT                4               // hit flashes that are done
+#define FRAME_KINDS                 5
+
+#define BENCH_LOOPS                 1000            // numbers drawn for each path by the bench command
+#define BENCH_ROW                   MAP_HEIGHT + 6  // row below everything the game draws
+
+// the status rows and the bench row are below the map, so the bench row being on screen covers them all
+#if MAP_WIDTH > SCREEN_WIDTH || BENCH_ROW >= SCREEN_HEIGHT
+#error "the map and the rows below it have to fit on the screen"
+#endif
 
 /// game structure
 struct stephen_game_t {
@@ -79,11 +183,30 @@ struct stephen_game_t {
 };
 static struct stephen_game_t game;
 
-// Create 2D array size of the playable area to map asteroids
-static uint8_t asteroids[MAP_WIDTH-1][MAP_HEIGHT-1];
+// Asteroids in the playable area, see HasAsteroid() and SetAsteroid()
+static uint64_t asteroids[FIELD_ROWS]; ///< bit set for every cell with an asteroid
+static uint64_t largeAsteroids[FIELD_ROWS]; ///< bit set for every asteroid of the O type
+// Stored column of map column 0, the columns form a ring so scrolling only moves this
+static uint8_t fieldHead;
 
-// Shots fired
-static char_object_t shots[MAX_SHOTS];
+/// Shots in flight as parallel arrays, the ones in use are always the first count entries
+static struct {
+    uint8_t x[MAX_SHOTS]; ///< column of each shot
+    uint8_t y[MAX_SHOTS]; ///< row of each shot
+    uint8_t count; ///< shots in flight
+} shots;
+// Bit x of a row set for every column x with a shot in it, see PlaceShot() and LiftShot()
+static uint64_t shotCells[FIELD_ROWS];
+
+/// Hit flashes on screen as parallel arrays, the ones in use are always the first count entries
+static struct {
+    uint8_t x[MAX_EFFECTS]; ///< column of each flash
+    uint8_t y[MAX_EFFECTS]; ///< row of each flash
+    char glyph[MAX_EFFECTS]; ///< character shown
+    uint8_t color[MAX_EFFECTS]; ///< enum term_color it is shown in
+    tint_t start[MAX_EFFECTS]; ///< time it was shown at
+    uint8_t count; ///< flashes on screen
+} effects;
 
 /* note the user doesn't need to access these functions directly so they are
    defined here instead of in the .h file
@@ -104,16 +227,70 @@ static void UpdateShotCooldown(void);
 static void GenerateAsteroidColumn(void);
 static void ShiftAsteroidColumns(void);
 static void GenerateAndShift(void);
-static void ResetScreenColor(void);
+static void GameTick(void);
+static uint16_t ScrollPeriod(void);
 static void IncreaseScore(void);
 static void Shoot(void);
-static void MoveRightShot(char_object_t * o);
+static void MoveShots(void);
+static uint8_t MoveRightShot(uint8_t i);
+static void RemoveShot(uint8_t i);
+static void EndShotsAt(uint8_t x, uint8_t y);
+static void ShootAsteroid(uint8_t x, uint8_t y);
 static void DecreaseCooldown(void);
 static void UpdateDifficulty(void);
 static void GameOver(void);
+static void DrawShip(void);
+static uint64_t HasAsteroid(uint8_t x, uint8_t y);
+static void SetAsteroid(uint8_t x, uint8_t y, uint8_t type);
+static uint64_t MapRow(uint64_t bits);
+static void PlaceShot(uint8_t i);
+static void LiftShot(uint8_t i);
+static void HitShip(void);
+static void AddEffect(uint8_t x, uint8_t y, char glyph, enum term_color color);
+static void DrawEffect(uint8_t i);
+static void DrawEffects(void);
+static void EndEffect(uint8_t i);
+static void EndEffectsAt(uint8_t x, uint8_t y);
+static void ExpireEffects(void);
+static void DrawCell(uint8_t x, uint8_t y);
+static void DrawHud(void);
+static void DrawNumber(unsigned int n, uint8_t * shown, uint8_t x, uint8_t y);
+static enum term_color ChargeColor(uint8_t charge);
+static void Bench(void);
+static void Commit(uint8_t kind);
+static void ReportBytes(void);
+static void ReportPercentile(uint8_t percent);
 
-static uint8_t gRechargingWeapon = 0;
+/// game ticks left until each timed part of the game runs again
+static struct {
+    uint8_t score; ///< until the score goes up for staying alive
+    uint8_t shots; ///< until the shots move
+    uint8_t recharge; ///< until the weapon gains a charge
+    task_handle_t tick; ///< GameTick in the task list, TASK_NO_HANDLE when it is not
+    tint_t last; ///< time the last tick was counted up to
+    uint16_t scrollDue; ///< ms since the asteroid field was due to move last
+} ticks;
+/// Time (ms) between moves of the asteroid field at each difficulty level
+static const uint16_t scrollPeriods[DIFFICULTY_LEVELS] = {1000, 800, 640, 510, 410, 330, 260, 200, 140, 90, 60};
+/// Score each difficulty level after the first starts at
+static const uint8_t levelScores[DIFFICULTY_LEVELS - 1] = {25, 35, 45, 70, 90, 100, 110, 120, 130, 150};
+/// values currently shown on the status lines
+static struct {
+    uint8_t score; ///< digits in the score
+    uint8_t difficulty; ///< digits in the difficulty
+    uint8_t health; ///< hearts
+    uint8_t charge; ///< charge bar segments
+    uint8_t stale; ///< HUD_ flags of values to draw again on the next tick
+} hud;
+/// bytes sent for each kind of frame
+static struct {
+    uint32_t bytes; ///< bytes in every frame of this kind
+    uint16_t frames; ///< frames of this kind
+    uint16_t largest; ///< bytes in the largest frame of this kind
+} frameBytes[FRAME_KINDS];
+static const char * frameNames[FRAME_KINDS] = {"shift", "shot", "move", "status", "effect"};
 static uint8_t asteroidSpawnProbability = STARTING_DIFFICULTY; // (1/asteroidSpawnChance) [e.g increasing spawn chance decreases spawn rate]
+static uint8_t difficulty; ///< difficulty level, 0 is the first
 
 void StephenGame_Init(void) {
     // Register the module with the game system and give it the name "MUH3"
@@ -127,19 +304,28 @@ void StephenGame_Init(void) {
  *  Play game
 */
 void Play(void) {
-    volatile uint8_t i, j;
+    volatile uint8_t i;
 
     // clear the screen
     Game_ClearScreen();
+    // framebuffer starts out matching the blank screen
+    Screen_Init();
     // draw a box around our map
-    Game_DrawRect(0, 0, MAP_WIDTH, MAP_HEIGHT);
+    Screen_DrawRect(0, 0, MAP_WIDTH, MAP_HEIGHT);
+    // the status lines can wait when the UART falls behind
+    Screen_SetStatusRows(MAP_HEIGHT + 1);
 
     // Initialize game variables
-    for(i = 0; i < MAP_WIDTH-1; i++) {
-        for(j = 0; j < MAP_HEIGHT-1; j++) {
-            asteroids[i][j] = 0;
-        }
+    for(i = 0; i < FIELD_ROWS; i++) {
+        asteroids[i] = 0;
+        largeAsteroids[i] = 0;
+        shotCells[i] = 0;
     }
+    shots.count = 0;
+    fieldHead = 0;
+    // a new game starts over at the first difficulty level
+    difficulty = 0;
+    asteroidSpawnProbability = STARTING_DIFFICULTY;
 
     // Set default position of space ship
     game.x = 1;
@@ -149,16 +335,18 @@ void Play(void) {
     game.shotsFired = 0;
     game.health = 3;
     game.shotCooldown = 6;
+    effects.count = 0;
 
     // Draw the space ship
-    Game_SetColor(ForegroundCyan);
-    Game_CharXY(game.c, game.x, game.y);
-    Game_SetColor(ForegroundWhite);
+    DrawShip();
     Game_RegisterPlayer1Receiver(Receiver);
 
     // Hide the cursor
     Game_HideCursor();
 
+    // Labels for the status lines
+    DrawHud();
+
     // Set cursor below the game view and show score
     UpdateScore();
 
@@ -171,35 +359,42 @@ void Play(void) {
     // Show starting difficulty
     UpdateDifficulty();
 
-    // Task schedule generating and shifting of asteroids
-    Task_Schedule(GenerateAndShift, 0, 500, 1000);
-    // Increase the score by static amount just for player staying alive
-    Task_Schedule(IncreaseScore, 0, 2500, 2500);
+    // One task runs the whole game, everything timed counts down game ticks
+    // count as if the field last moved SCROLL_DELAY ms before it is due
+    ticks.last = TimeNow();
+    ticks.scrollDue = ScrollPeriod() > SCROLL_DELAY ? ScrollPeriod() - SCROLL_DELAY : 0;
+    ticks.score = TICKS(SCORE_PERIOD);
+    ticks.shots = TICKS(FIRE_SPEED);
+    ticks.recharge = TICKS(RECHARGE_RATE);
+    hud.stale = 0;
+    // a new game started over a running one keeps the tick it has, only one may ever be in the task list
+    if(ticks.tick == TASK_NO_HANDLE) ticks.tick = Task_ScheduleHandle(GameTick, 0, GAME_TICK, GAME_TICK);
 }
 
 /** @brief Function to end game
  */
 void GameOver(void) {
-    Task_Remove(GenerateAndShift, 0);
-    Task_Remove(IncreaseScore, 0);
+    Task_Cancel(ticks.tick);
+    ticks.tick = TASK_NO_HANDLE;
 
     volatile uint8_t i;
-    char_object_t * shot = 0;
-    for(i = 0; i < MAX_SHOTS; i++) {
-        if(shots[i].status == 1) { // if active shot
-            shot = &shots[i];
-            shot->status = 0;
-            Task_Remove((task_t)MoveRightShot, shot);
-        }
-    }
+    uint8_t x;
+    shots.count = 0;
+    effects.count = 0;
+    for(i = 0; i < FIELD_ROWS; i++) shotCells[i] = 0;
 
-    Game_SetColor(ForegroundRed);
-    Game_CharXY('\r', 0, MAP_HEIGHT + 1);
-    Game_Printf("Game Over! Final score: %d, Total shots fired: %d", game.score, game.shotsFired);
+    Screen_SetColor(ForegroundRed);
+    x = Screen_Text(0, SCORE_ROW, "Game Over! Final score: ");
+    x += Screen_Signed(x, SCORE_ROW, game.score);
+    x += Screen_Text(x, SCORE_ROW, ", Total shots fired: ");
+    Screen_Signed(x, SCORE_ROW, game.shotsFired);
+    Screen_FlushAll();
+    Screen_RestoreColor();
     // unregister the receiver used to run the game
     Game_UnregisterPlayer1Receiver(Receiver);
     // show cursor (it was hidden at the beginning
     Game_CharXY('\r', 0, MAP_HEIGHT + 5);
+    Screen_Invalidate(); // the cursor is no longer where the framebuffer left it
     Game_ShowCursor();
     Game_GameOver();
 }
@@ -208,7 +403,61 @@ void GameOver(void) {
  */
 void IncreaseScore(void) {
     game.score += 1;
-    Task_Queue(UpdateScore, 0);
+    hud.stale |= HUD_SCORE;
+}
+
+/** @brief Advance the game by one tick
+ *
+ * Runs every GAME_TICK ms and moves everything that is timed in a fixed
+ * order: shots, the asteroid field, weapon charge, score, hit flashes and
+ * last the status lines, since running out of health ends the game. The
+ * asteroid field keeps its own time since most of its periods are not a
+ * whole number of ticks.
+ */
+void GameTick(void) {
+    uint8_t stale;
+    tint_t elapsed = TimeSince(ticks.last);
+    uint16_t period = ScrollPeriod();
+    ticks.last += elapsed;
+    // shots move every FIRE_SPEED ms while there are any
+    if(shots.count == 0) ticks.shots = TICKS(FIRE_SPEED);
+    else if(--ticks.shots == 0) {
+        ticks.shots = TICKS(FIRE_SPEED);
+        MoveShots();
+    }
+    // the field moves at the rate of the difficulty, counted in real time so a late tick does not slow it down
+    ticks.scrollDue += elapsed;
+    if(ticks.scrollDue >= period) {
+        ticks.scrollDue -= period;
+        // when the game cannot keep up it falls behind by at most one more move
+        if(ticks.scrollDue > period) ticks.scrollDue = period;
+        GenerateAndShift();
+    }
+    // the weapon recharges every RECHARGE_RATE ms until it is full
+    if(game.shotCooldown >= MAX_CHARGE) ticks.recharge = TICKS(RECHARGE_RATE);
+    else if(--ticks.recharge == 0) {
+        ticks.recharge = TICKS(RECHARGE_RATE);
+        DecreaseCooldown();
+    }
+    // Increase the score by static amount just for player staying alive
+    if(--ticks.score == 0) {
+        ticks.score = TICKS(SCORE_PERIOD);
+        IncreaseScore();
+    }
+    ExpireEffects();
+    stale = hud.stale;
+    hud.stale = 0;
+    if(stale & HUD_SCORE) UpdateScore();
+    if(stale & HUD_CHARGE) UpdateShotCooldown();
+    if(stale & HUD_HEALTH) UpdateHealth();
+}
+
+/** @brief Find how often the asteroid field moves at the current difficulty
+ *
+ * @return time in ms between moves
+ */
+uint16_t ScrollPeriod(void) {
+    return scrollPeriods[difficulty];
 }
 
 /** @brief Generate a new row of asteroids and shift the columns to the left
@@ -216,10 +465,14 @@ void IncreaseScore(void) {
 void GenerateAndShift(void) {
     GenerateAsteroidColumn();
     ShiftAsteroidColumns();
+    Commit(FRAME_SHIFT);
 }
 
 
 /** @brief Generate a new column of asteroids to display on the terminal window
+ *
+ * Only the field is updated, ShiftAsteroidColumns draws the column once it
+ * has moved in. Drawing it here would have it sent before the scroll.
  */
 void GenerateAsteroidColumn(void) {
     uint8_t randomCheck, randomType;
@@ -228,143 +481,344 @@ void GenerateAsteroidColumn(void) {
         randomCheck = random_int(1, asteroidSpawnProbability);
         if(randomCheck == 1) { // create asteroid if probability check
             randomType = random_int(1, 2);
-            if(randomType == 1) {
-                asteroids[MAX_COLUMNS][i] = 1; // o type
-                Game_CharXY('o', MAX_COLUMNS, i);
-            }
-            else {
-                asteroids[MAX_COLUMNS][i] = 2; // O type
-                Game_CharXY('O', MAX_COLUMNS, i);
-            }
-        }
-        else { // did not pass check, overwrite with blank
-            asteroids[MAX_COLUMNS][i] = 0;
-            Game_CharXY(' ', MAX_COLUMNS, i);
+            if(randomType == 1) SetAsteroid(MAX_COLUMNS, i, SMALL_ASTEROID);
+            else SetAsteroid(MAX_COLUMNS, i, LARGE_ASTEROID);
         }
+        else SetAsteroid(MAX_COLUMNS, i, NO_ASTEROID); // did not pass check, overwrite with blank
     }
 }
 
 /** @brief Shift each column of asteroids on the terminal window to the left
  */
 void ShiftAsteroidColumns(void) {
-    volatile uint8_t column, i;
-    for(column = 1; column < MAP_WIDTH-1; column++) {
-        for(i = 1; i < MAP_HEIGHT; i++) {
-            asteroids[column][i] = asteroids[column+1][i];
-            if(asteroids[column][i] == 0 && !(game.x == column && game.y == i)) {
-                // check if it overlaps a shot
-                uint8_t checkShots, foundShot = 0;
-                for(checkShots = 0; checkShots < MAX_SHOTS; checkShots++) {
-                    if(shots[checkShots].status && shots[checkShots].x == column && shots[checkShots].y == i) {
-                        foundShot = 1;
-                        break;
-                    }
-                }
-                if(!foundShot) Game_CharXY(' ', column, i);
-            }
-            else if(asteroids[column][i] == 1) {
-                if(game.x == column && game.y == i) { // if collided
-                    asteroids[column][i] = 0; // destroy asteroid
-                    Game_SetColor(BackgroundRed);
-                    Game_CharXY('*', column, i);
-                    Game_SetColor(BackgroundBlack);
-                    Game_Bell();
-                    if(game.health > 0) game.health--;
-                    Task_Queue(UpdateHealth, 0);
-                    Task_Schedule(ResetScreenColor, 0, 250, 0);
-                }
-                else Game_CharXY('o', column, i);
-            }
-            else if(asteroids[column][i] == 2) {
-                if(game.x == column && game.y == i) { // if collided
-                    asteroids[column][i] = 0; // destroy asteroid
-                    Game_SetColor(BackgroundRed);
-                    Game_CharXY('*', column, i);
-                    Game_SetColor(BackgroundBlack);
-                    Game_Bell();
-                    if(game.health > 0) game.health--;
-                    Task_Queue(UpdateHealth, 0);
-                    Task_Schedule(ResetScreenColor, 0, 250, 0);
+    volatile uint8_t row;
+    uint8_t column;
+    uint64_t present, large, shot, flash, border, hits;
+    uint8_t i;
+    // let the terminal move the field, the ship, shots and flashes stay put so they get drawn again below
+    Screen_Keep(game.x, game.y);
+    for(i = 0; i < shots.count; i++) Screen_Keep(shots.x[i], shots.y[i]);
+    for(i = 0; i < effects.count; i++) Screen_Keep(effects.x[i], effects.y[i]);
+    Screen_ScrollLeft(1, 1, MAX_COLUMNS, MAP_HEIGHT-1);
+    // moving every column one to the left is just moving where the ring starts
+    fieldHead = (fieldHead + 1) & (FIELD_COLUMNS - 1);
+    // what was in column 1 hit the border, the old column 0 comes around as the empty column past the right edge
+    border = ~FIELD_BIT(0);
+    for(row = 0; row < FIELD_ROWS; row++) {
+        asteroids[row] &= border;
+        largeAsteroids[row] &= border;
+    }
+    if(HasAsteroid(game.x, game.y)) { // asteroid ran into the ship
+        SetAsteroid(game.x, game.y, NO_ASTEROID); // destroy asteroid
+        HitShip();
+    }
+    // the field can move faster than the shots, an asteroid that moved onto a shot is hit as if the shot moved into it
+    for(row = 1; row < MAP_HEIGHT; row++) {
+        hits = MapRow(asteroids[row]) & shotCells[row];
+        for(column = 1; hits; column++) {
+            if(!(hits & SHOT_BIT(column))) continue;
+            hits &= ~SHOT_BIT(column);
+            EndShotsAt(column, row);
+            ShootAsteroid(column, row);
+        }
+    }
+    for(row = 1; row < MAP_HEIGHT; row++) {
+        present = MapRow(asteroids[row]) >> 1;
+        large = MapRow(largeAsteroids[row]) >> 1;
+        shot = shotCells[row] >> 1;
+        flash = 0;
+        for(i = 0; i < effects.count; i++) if(effects.y[i] == row) flash |= SHOT_BIT(effects.x[i]);
+        flash >>= 1;
+        for(column = 1; column <= MAX_COLUMNS; column++, present >>= 1, large >>= 1, shot >>= 1, flash >>= 1) {
+            if(flash & 1) continue; // left to DrawEffects() so the cell is not changed and put back every shift
+            if(present & 1) Screen_CharXY((large & 1) ? 'O' : 'o', column, row);
+            else {
+                if(game.x == column && game.y == row) DrawShip();
+                else if(shot & 1) { // overlaps a shot
+                    Screen_SetColor(ForegroundYellow);
+                    Screen_CharXY('-', column, row);
+                    Screen_SetColor(ForegroundWhite);
                 }
-                else Game_CharXY('O', column, i);
+                else Screen_CharXY(' ', column, row);
             }
         }
     }
+    // hit flashes stay put while the field moves under them, only a terminal scroll moved them away
+    DrawEffects();
+}
+
+/** @brief Check a cell of the field for an asteroid
+ *
+ * @param x column of the cell
+ * @param y row of the cell
+ * @return non zero if there is an asteroid in the cell
+ */
+uint64_t HasAsteroid(uint8_t x, uint8_t y) {
+    return asteroids[y] & FIELD_BIT(x);
+}
+
+/** @brief Put an asteroid in a cell of the field or clear it
+ *
+ * @param x column of the cell
+ * @param y row of the cell
+ * @param type NO_ASTEROID, SMALL_ASTEROID or LARGE_ASTEROID
+ */
+void SetAsteroid(uint8_t x, uint8_t y, uint8_t type) {
+    uint64_t bit = FIELD_BIT(x);
+    asteroids[y] &= ~bit;
+    largeAsteroids[y] &= ~bit;
+    if(type != NO_ASTEROID) asteroids[y] |= bit;
+    if(type == LARGE_ASTEROID) largeAsteroids[y] |= bit;
+}
+
+/** @brief Line up a row of the field with the map
+ *
+ * @param bits row of the field as stored
+ * @return the same row with column x of the map in bit x
+ */
+uint64_t MapRow(uint64_t bits) {
+    if(fieldHead == 0) return bits;
+    return (bits >> fieldHead) | (bits << (FIELD_COLUMNS - fieldHead));
+}
+
+/** @brief Show the ship was hit and take away health
+ */
+void HitShip(void) {
+    AddEffect(game.x, game.y, '*', BackgroundRed);
+    Game_Bell();
+    if(game.health > 0) game.health--;
+    hud.stale |= HUD_HEALTH;
+}
+
+/** @brief Flash a cell for EFFECT_TIME ms
+ *
+ * When every flash is in use the oldest one ends early to make room.
+ *
+ * @param x column of the cell
+ * @param y row of the cell
+ * @param glyph character to show
+ * @param color foreground or background color to show it in
+ */
+void AddEffect(uint8_t x, uint8_t y, char glyph, enum term_color color) {
+    uint8_t i, oldest = 0;
+    if(effects.count == MAX_EFFECTS) {
+        for(i = 1; i < effects.count; i++) {
+            if(TimeSince(effects.start[i]) > TimeSince(effects.start[oldest])) oldest = i;
+        }
+        EndEffect(oldest);
+    }
+    i = effects.count++;
+    effects.x[i] = x;
+    effects.y[i] = y;
+    effects.glyph[i] = glyph;
+    effects.color[i] = color;
+    effects.start[i] = TimeNow();
+    DrawEffect(i);
+}
+
+/** @brief Draw a flash into the framebuffer
+ *
+ * @param i index of the flash
+ */
+void DrawEffect(uint8_t i) {
+    Screen_SetColor((enum term_color)effects.color[i]);
+    Screen_CharXY(effects.glyph[i], effects.x[i], effects.y[i]);
+    Screen_SetColor(ForegroundWhite);
+    Screen_SetColor(BackgroundBlack);
+}
+
+/** @brief Draw every flash again after the cells under them were redrawn
+ */
+void DrawEffects(void) {
+    uint8_t i;
+    for(i = 0; i < effects.count; i++) DrawEffect(i);
+}
+
+/** @brief End a flash and show what is in its cell again
+ *
+ * The last flash takes its place.
+ *
+ * @param i index of the flash
+ */
+void EndEffect(uint8_t i) {
+    uint8_t x = effects.x[i], y = effects.y[i];
+    effects.count--;
+    effects.x[i] = effects.x[effects.count];
+    effects.y[i] = effects.y[effects.count];
+    effects.glyph[i] = effects.glyph[effects.count];
+    effects.color[i] = effects.color[effects.count];
+    effects.start[i] = effects.start[effects.count];
+    DrawCell(x, y);
+}
+
+/** @brief End every flash in a cell
+ *
+ * @param x column of the cell
+ * @param y row of the cell
+ */
+void EndEffectsAt(uint8_t x, uint8_t y) {
+    uint8_t i = 0;
+    while(i < effects.count) {
+        if(effects.x[i] == x && effects.y[i] == y) EndEffect(i);
+        else i++;
+    }
+}
+
+/** @brief End the flashes that have been shown for EFFECT_TIME ms in one pass
+ *
+ * Runs on every game tick.
+ */
+void ExpireEffects(void) {
+    uint8_t i = 0, ended = 0;
+    while(i < effects.count) {
+        if(TimeSince(effects.start[i]) >= EFFECT_TIME) {
+            EndEffect(i);
+            ended = 1;
+        }
+        else i++;
+    }
+    if(ended) Commit(FRAME_EFFECT);
+}
+
+/** @brief Draw whatever is in a cell of the field
+ *
+ * @param x column of the cell
+ * @param y row of the cell
+ */
+void DrawCell(uint8_t x, uint8_t y) {
+    if(game.x == x && game.y == y) DrawShip();
+    else if(HasAsteroid(x, y)) Screen_CharXY((largeAsteroids[y] & FIELD_BIT(x)) ? 'O' : 'o', x, y);
+    else if(shotCells[y] & SHOT_BIT(x)) {
+        Screen_SetColor(ForegroundYellow);
+        Screen_CharXY('-', x, y);
+        Screen_SetColor(ForegroundWhite);
+    }
+    else Screen_CharXY(' ', x, y);
 }
 
 /** @brief Initiate shooting the weapon from the player
  */
 void Shoot(void) {
     if(game.shotCooldown >= 3) { // at least 3 to shoot one
-        char_object_t * shot = 0;
-
-        volatile uint8_t i;
-        // find and unused bullet
-        for(i = 0; i < MAX_SHOTS; i++) if(shots[i].status == 0) shot = &shots[i];
-        if(shot) { // if found empty slot
+        if(shots.count < MAX_SHOTS) { // if there is room for another shot
+            uint8_t i = shots.count++;
             game.shotCooldown -= 3;
-            shot->status = 1;
-            shot->y = game.y;
-            shot->x = game.x+1;
-            Game_SetColor(ForegroundYellow);
-            Game_CharXY('-', game.x+1, game.y);
-            Game_SetColor(ForegroundWhite);
+            shots.x[i] = game.x+1;
+            shots.y[i] = game.y;
+            PlaceShot(i);
+            Screen_SetColor(ForegroundYellow);
+            Screen_CharXY('-', game.x+1, game.y);
+            Screen_SetColor(ForegroundWhite);
             game.shotsFired++;
-            Task_Queue((task_t)UpdateShotCooldown, 0);
-            Task_Schedule((task_t)MoveRightShot, shot, FIRE_SPEED, FIRE_SPEED);
-
-            if(!gRechargingWeapon) { // if task is not already assigned to recharge
-                gRechargingWeapon = 1;
-                Task_Schedule((task_t)DecreaseCooldown, 0, RECHARGE_RATE, RECHARGE_RATE);
-            }
+            hud.stale |= HUD_CHARGE;
         }
     }
 }
 
-/** @brief Move a shot particle to the right
+/** @brief Move every shot in flight to the right in one pass
  *
- * @param o pointer to the shot object
+ * Runs every FIRE_SPEED ms while there are shots. Shots that hit something
+ * or reach the edge are taken out by moving the last shot into their place.
  */
-void MoveRightShot(char_object_t * o) {
-    if (o->x < MAP_WIDTH-2) { // if not at edge
-        // clear location
-        Game_CharXY(' ', o->x, o->y);
-        o->x++;
-        if(asteroids[o->x][o->y]) { // if collided
-            asteroids[o->x][o->y] = 0;
-            Game_SetColor(BackgroundYellow);
-            Game_CharXY('*', o->x, o->y);
-            Game_SetColor(BackgroundBlack);
-            Game_Bell();
-            o->status = 0;
-            game.score += 1;
-            Task_Remove((task_t)MoveRightShot, o);
-            Task_Queue((task_t)UpdateScore, 0);
-        }
-        else { // if no collision, move shot
-            Game_SetColor(ForegroundYellow);
-            Game_CharXY('-', o->x, o->y);
-            Game_SetColor(ForegroundWhite);
-        }
+void MoveShots(void) {
+    uint8_t i = 0, step;
+    while(i < shots.count) {
+        for(step = 0; step < SHOT_SPEED; step++) if(!MoveRightShot(i)) break;
+        if(step < SHOT_SPEED) RemoveShot(i); // shot is gone
+        else i++;
     }
-    else { // at edge
-        // clear the shot
-        Game_CharXY(' ', o->x, o->y);
-        o->status = 0;
-        Task_Remove((task_t)MoveRightShot, o);
+    Commit(FRAME_SHOT);
+}
+
+/** @brief Move a shot particle one column to the right
+ *
+ * @param i index of the shot
+ * @return 1 if the shot is still in flight, 0 if it hit something or reached the edge
+ */
+uint8_t MoveRightShot(uint8_t i) {
+    uint8_t x = shots.x[i], y = shots.y[i];
+    // clear location
+    Screen_CharXY(' ', x, y);
+    LiftShot(i);
+    if(x >= MAP_WIDTH-2) return 0; // at edge
+    shots.x[i] = ++x;
+    if(HasAsteroid(x, y)) { // if collided
+        ShootAsteroid(x, y);
+        return 0;
     }
+    // if no collision, move shot
+    PlaceShot(i);
+    Screen_SetColor(ForegroundYellow);
+    Screen_CharXY('-', x, y);
+    Screen_SetColor(ForegroundWhite);
+    return 1;
+}
+
+/** @brief Take a shot out by moving the last shot into its place
+ *
+ * @param i index of the shot
+ */
+void RemoveShot(uint8_t i) {
+    shots.count--;
+    shots.x[i] = shots.x[shots.count];
+    shots.y[i] = shots.y[shots.count];
+}
+
+/** @brief Take out every shot in a cell
+ *
+ * @param x column of the cell
+ * @param y row of the cell
+ */
+void EndShotsAt(uint8_t x, uint8_t y) {
+    uint8_t i = 0;
+    while(i < shots.count) {
+        if(shots.x[i] == x && shots.y[i] == y) RemoveShot(i);
+        else i++;
+    }
+    shotCells[y] &= ~SHOT_BIT(x);
+}
+
+/** @brief Destroy an asteroid hit by a shot and score it
+ *
+ * @param x column of the asteroid
+ * @param y row of the asteroid
+ */
+void ShootAsteroid(uint8_t x, uint8_t y) {
+    SetAsteroid(x, y, NO_ASTEROID);
+    AddEffect(x, y, '*', BackgroundYellow);
+    Game_Bell();
+    game.score += 1;
+    hud.stale |= HUD_SCORE;
+}
+
+/** @brief Mark the cell of a shot as holding one
+ *
+ * @param i index of the shot
+ */
+void PlaceShot(uint8_t i) {
+    shotCells[shots.y[i]] |= SHOT_BIT(shots.x[i]);
+}
+
+/** @brief Clear the mark of a shot that is leaving its cell
+ *
+ * The mark stays when another shot is in the same cell.
+ *
+ * @param i index of the shot
+ */
+void LiftShot(uint8_t i) {
+    uint8_t j;
+    for(j = 0; j < shots.count; j++) {
+        if(j != i && shots.x[j] == shots.x[i] && shots.y[j] == shots.y[i]) return;
+    }
+    shotCells[shots.y[i]] &= ~SHOT_BIT(shots.x[i]);
 }
 
 /** @brief Decrease the cooldown timer for shooting again
  */
 void DecreaseCooldown(void) {
-    if(game.shotCooldown < 6) {
+    if(game.shotCooldown < MAX_CHARGE) {
         game.shotCooldown++;
-        Task_Queue(UpdateShotCooldown, 0);
-    }
-    else { // greater than or equal to 6
-        gRechargingWeapon = 0;
-        Task_Remove((task_t)DecreaseCooldown, 0);
+        hud.stale |= HUD_CHARGE;
     }
 }
 
@@ -372,57 +826,25 @@ void DecreaseCooldown(void) {
  */
 void Help(void) {
     Game_Printf("WASD to move the spaceship\r\nSPACEBAR to FIRE\r\n");
-    Game_Printf("Weapon recharges over time. Difficulty increases with score.\r\n");
+    Game_Printf("Weapon recharges over time. Difficulty and speed increase with score.\r\n");
 }
 
 /** @brief Update the score text to the most recent value and adjust difficulty
  */
 void UpdateScore(void) {
+    uint8_t level;
     /* Set cursor below the game view and show score */
-    Game_CharXY('\r', 0, MAP_HEIGHT + 1);
-    Game_Printf("Score: %d", game.score);
+    DrawNumber(game.score, &hud.score, SCORE_X, SCORE_ROW);
+    Commit(FRAME_STATUS);
 
-    /* Conditional block below is simply just setting the difficulty
-    based on whatever score the player achieves */
-    if(game.score == 25) {
-        asteroidSpawnProbability = STARTING_DIFFICULTY - 1;
-        Task_Queue((task_t)UpdateDifficulty, 0);
-    }
-    else if(game.score == 35) {
-        asteroidSpawnProbability = STARTING_DIFFICULTY - 2;
-        Task_Queue((task_t)UpdateDifficulty, 0);
-    }
-    else if(game.score == 45) {
-        asteroidSpawnProbability = STARTING_DIFFICULTY - 3;
-        Task_Queue((task_t)UpdateDifficulty, 0);
-    }
-    else if(game.score == 70) {
-        asteroidSpawnProbability = STARTING_DIFFICULTY - 4;
-        Task_Queue((task_t)UpdateDifficulty, 0);
-    }
-    else if(game.score == 90) {
-        asteroidSpawnProbability = STARTING_DIFFICULTY - 5;
-        Task_Queue((task_t)UpdateDifficulty, 0);
-    }
-    else if(game.score == 100) {
-        asteroidSpawnProbability = STARTING_DIFFICULTY - 6;
-        Task_Queue((task_t)UpdateDifficulty, 0);
-    }
-    else if(game.score == 110) {
-        asteroidSpawnProbability = STARTING_DIFFICULTY - 7;
-        Task_Queue((task_t)UpdateDifficulty, 0);
-    }
-    else if(game.score == 120) {
-        asteroidSpawnProbability = STARTING_DIFFICULTY - 8;
-        Task_Queue((task_t)UpdateDifficulty, 0);
-    }
-    else if(game.score == 130) {
-        asteroidSpawnProbability = STARTING_DIFFICULTY - 9;
-        Task_Queue((task_t)UpdateDifficulty, 0);
-    }
-    else if(game.score == 150) {
-        asteroidSpawnProbability = STARTING_DIFFICULTY - 10;
-        Task_Queue((task_t)UpdateDifficulty, 0);
+    /* The difficulty follows from the score, several points can be added in
+    the same tick so a level is reached once the score is at least its start */
+    for(level = 0; level < DIFFICULTY_LEVELS - 1 && game.score >= levelScores[level]; level++);
+    if(level != difficulty) {
+        difficulty = level;
+        // every level makes asteroids more likely, up to one in every cell
+        asteroidSpawnProbability = STARTING_DIFFICULTY > level ? STARTING_DIFFICULTY - level : 1;
+        UpdateDifficulty();
     }
 }
 
@@ -430,79 +852,98 @@ void UpdateScore(void) {
  */
 void UpdateDifficulty(void) {
     /* Set cursor below the game view and show difficulty */
-    uint8_t score = (STARTING_DIFFICULTY-asteroidSpawnProbability) + 1;
-    Game_CharXY('\r', 0, MAP_HEIGHT + 4);
-    Game_Printf("Difficulty: %d", score);
+    DrawNumber(difficulty + 1, &hud.difficulty, DIFFICULTY_X, DIFFICULTY_ROW);
+    Commit(FRAME_STATUS);
 }
 
 /** @brief Update the text and color for player health
  */
 void UpdateHealth(void) {
-    Game_CharXY('\r', 0, MAP_HEIGHT + 2);
-    Game_Printf("Health: ");
-    Game_SetColor(ForegroundRed);
-    if(game.health >= 3) Game_Printf("<3 <3 <3");
-    else if(game.health == 2) Game_Printf("<3 <3   ");
-    else if(game.health == 1) Game_Printf("<3      ");
-    else if(game.health == 0) {
-        Game_Printf(":(      ");
-        GameOver();
+    volatile uint8_t i;
+    uint8_t health = game.health > MAX_HEALTH ? MAX_HEALTH : game.health;
+    if(health != hud.health) {
+        Screen_SetColor(ForegroundRed);
+        for(i = 0; i < MAX_HEALTH; i++) {
+            // only the hearts between the old and the new health change
+            if(hud.health != HUD_UNKNOWN && (i < health) == (i < hud.health)) continue;
+            if(i < health) Screen_Text(HEALTH_X + i*3, HEALTH_ROW, "<3");
+            else if(i == 0) Screen_Text(HEALTH_X, HEALTH_ROW, ":(");
+            else Screen_Text(HEALTH_X + i*3, HEALTH_ROW, "  ");
+        }
+        Screen_SetColor(ForegroundWhite);
+        hud.health = health;
     }
-    Game_SetColor(ForegroundWhite);
+    if(health == 0) GameOver();
+    Commit(FRAME_STATUS);
 }
 
-/** @brief Resets all colors to default
+/** @brief Draw the ship, or the collision marker if it was just hit
  */
-void ResetScreenColor(void) {
-    Game_SetColor(ForegroundCyan);
-    Game_CharXY(game.c, game.x, game.y); // reset back to spaceship too
-    Game_SetColor(ForegroundWhite);
+void DrawShip(void) {
+    Screen_SetFocus(game.x); // cells around the ship are sent first
+    Screen_SetColor(ForegroundCyan);
+    Screen_CharXY(game.c, game.x, game.y);
+    Screen_SetColor(ForegroundWhite);
 }
 
 /** @brief Updates the text and color for shot cooldown
  */
 void UpdateShotCooldown(void) {
-    Game_CharXY('\r', 0, MAP_HEIGHT + 3);
-    Game_Printf("Weapon Charge: [");
-    if(game.shotCooldown == 6) {
-        Game_SetColor(ForegroundGreen);
-        Game_Printf("++++++");
-        Game_SetColor(ForegroundWhite);
-        Game_Printf("]");
-    }
-    else if(game.shotCooldown == 5) {
-        Game_SetColor(ForegroundYellow);
-        Game_Printf("+++++ ");
-        Game_SetColor(ForegroundWhite);
-        Game_Printf("]");
-    }
-    else if(game.shotCooldown == 4) {
-        Game_SetColor(ForegroundYellow);
-        Game_Printf("++++  ");
-        Game_SetColor(ForegroundWhite);
-        Game_Printf("]");
-    }
-    else if(game.shotCooldown == 3) {
-        Game_SetColor(ForegroundYellow);
-        Game_Printf("+++   ");
-        Game_SetColor(ForegroundWhite);
-        Game_Printf("]");
-    }
-    else if(game.shotCooldown == 2) {
-        Game_SetColor(ForegroundRed);
-        Game_Printf("++    ");
-        Game_SetColor(ForegroundWhite);
-        Game_Printf("]");
-    }
-    else if(game.shotCooldown == 1) {
-        Game_SetColor(ForegroundRed);
-        Game_Printf("+     ");
-        Game_SetColor(ForegroundWhite);
-        Game_Printf("]");
-    }
-    else if(game.shotCooldown == 0) {
-        Game_Printf("      ]");
+    volatile uint8_t i;
+    uint8_t charge = game.shotCooldown;
+    uint8_t recolor;
+    if(charge == hud.charge) return;
+    // the whole bar changes color at some levels, otherwise only the segments that were added or used up
+    recolor = hud.charge == HUD_UNKNOWN || ChargeColor(charge) != ChargeColor(hud.charge);
+    Screen_SetColor(ChargeColor(charge));
+    for(i = 0; i < MAX_CHARGE; i++) {
+        if(!recolor && (i < charge) == (i < hud.charge)) continue;
+        Screen_CharXY(i < charge ? '+' : ' ', CHARGE_X + i, CHARGE_ROW);
     }
+    Screen_SetColor(ForegroundWhite);
+    hud.charge = charge;
+    Commit(FRAME_STATUS);
+}
+
+/** @brief Pick the color of the charge bar
+ *
+ * @param charge segments in the bar
+ */
+enum term_color ChargeColor(uint8_t charge) {
+    if(charge >= MAX_CHARGE) return ForegroundGreen;
+    if(charge >= 3) return ForegroundYellow;
+    if(charge >= 1) return ForegroundRed;
+    return ForegroundWhite;
+}
+
+/** @brief Draw the labels of the status lines and forget the values shown after them
+ */
+void DrawHud(void) {
+    Screen_Text(0, SCORE_ROW, "Score: ");
+    Screen_Text(0, HEALTH_ROW, "Health: ");
+    Screen_Text(0, CHARGE_ROW, "Weapon Charge: [");
+    Screen_Text(CHARGE_X + MAX_CHARGE, CHARGE_ROW, "]");
+    Screen_Text(0, DIFFICULTY_ROW, "Difficulty: ");
+    hud.score = 0;
+    hud.difficulty = 0;
+    hud.health = HUD_UNKNOWN;
+    hud.charge = HUD_UNKNOWN;
+}
+
+/** @brief Draw a number left aligned and blank what is left of a longer previous one
+ *
+ * The framebuffer drops digits that did not change so only those that did are sent.
+ *
+ * @param n number to draw
+ * @param shown characters currently shown, updated to the new count
+ * @param x column of the first digit
+ * @param y row of the number
+ */
+void DrawNumber(unsigned int n, uint8_t * shown, uint8_t x, uint8_t y) {
+    uint8_t width = Screen_Unsigned(x, y, n);
+    uint8_t i;
+    for(i = width; i < *shown; i++) Screen_CharXY(' ', x + i, y);
+    *shown = width;
 }
 
 /** @brief Move the player to the right
@@ -510,24 +951,15 @@ void UpdateShotCooldown(void) {
 void MoveRight(void) {
     // make sure we can move right
     if (game.x < MAP_WIDTH - 3) {
-        /* Clear location and update */
-        Game_CharXY(' ', game.x, game.y);
+        /* Clear location and update, a hit flash there ends when the ship moves on */
+        EndEffectsAt(game.x, game.y);
+        Screen_CharXY(' ', game.x, game.y);
         game.x++;
-        if(asteroids[game.x][game.y]) { // moved into asteroid
-            asteroids[game.x][game.y] = 0; // destroy asteroid
-            Game_SetColor(BackgroundRed);
-            Game_CharXY('*', game.x, game.y);
-            Game_SetColor(BackgroundBlack);
-            Game_Bell();
-            if(game.health > 0) game.health--;
-            Task_Queue(UpdateHealth, 0);
-            Task_Schedule(ResetScreenColor, 0, 250, 0);
-        }
-        else {
-            Game_SetColor(ForegroundCyan);
-            Game_CharXY(game.c, game.x, game.y);
-            Game_SetColor(ForegroundWhite);
+        if(HasAsteroid(game.x, game.y)) { // moved into asteroid
+            SetAsteroid(game.x, game.y, NO_ASTEROID); // destroy asteroid
+            HitShip();
         }
+        else DrawShip();
     }
 }
 
@@ -536,24 +968,15 @@ void MoveRight(void) {
 void MoveLeft(void) {
     // make sure we can move right
     if (game.x > 1) {
-        /* Clear location and update */
-        Game_CharXY(' ', game.x, game.y);
+        /* Clear location and update, a hit flash there ends when the ship moves on */
+        EndEffectsAt(game.x, game.y);
+        Screen_CharXY(' ', game.x, game.y);
         game.x--;
-        if(asteroids[game.x][game.y]) { // moved into asteroid
-            asteroids[game.x][game.y] = 0; // destroy asteroid
-            Game_SetColor(BackgroundRed);
-            Game_CharXY('*', game.x, game.y);
-            Game_SetColor(BackgroundBlack);
-            Game_Bell();
-            if(game.health > 0) game.health--;
-            Task_Queue(UpdateHealth, 0);
-            Task_Schedule(ResetScreenColor, 0, 250, 0);
-        }
-        else {
-            Game_SetColor(ForegroundCyan);
-            Game_CharXY(game.c, game.x, game.y);
-            Game_SetColor(ForegroundWhite);
+        if(HasAsteroid(game.x, game.y)) { // moved into asteroid
+            SetAsteroid(game.x, game.y, NO_ASTEROID); // destroy asteroid
+            HitShip();
         }
+        else DrawShip();
     }
 }
 
@@ -562,24 +985,15 @@ void MoveLeft(void) {
 void MoveDown(void) {
     // make sure we can move up
     if (game.y < MAP_HEIGHT - 1) {
-        /* Clear location and update */
-        Game_CharXY(' ', game.x, game.y);
+        /* Clear location and update, a hit flash there ends when the ship moves on */
+        EndEffectsAt(game.x, game.y);
+        Screen_CharXY(' ', game.x, game.y);
         game.y++;
-        if(asteroids[game.x][game.y]) { // moved into asteroid
-            asteroids[game.x][game.y] = 0; // destroy asteroid
-            Game_SetColor(BackgroundRed);
-            Game_CharXY('*', game.x, game.y);
-            Game_SetColor(BackgroundBlack);
-            Game_Bell();
-            if(game.health > 0) game.health--;
-            Task_Queue(UpdateHealth, 0);
-            Task_Schedule(ResetScreenColor, 0, 250, 0);
-        }
-        else {
-            Game_SetColor(ForegroundCyan);
-            Game_CharXY(game.c, game.x, game.y);
-            Game_SetColor(ForegroundWhite);
+        if(HasAsteroid(game.x, game.y)) { // moved into asteroid
+            SetAsteroid(game.x, game.y, NO_ASTEROID); // destroy asteroid
+            HitShip();
         }
+        else DrawShip();
     }
 }
 
@@ -588,24 +1002,15 @@ void MoveDown(void) {
 void MoveUp(void) {
     // make sure we can move right
     if (game.y > 1) {
-        /* Clear location and update */
-        Game_CharXY(' ', game.x, game.y);
+        /* Clear location and update, a hit flash there ends when the ship moves on */
+        EndEffectsAt(game.x, game.y);
+        Screen_CharXY(' ', game.x, game.y);
         game.y--;
-        if(asteroids[game.x][game.y]) { // moved into asteroid
-            asteroids[game.x][game.y] = 0; // destroy asteroid
-            Game_SetColor(BackgroundRed);
-            Game_CharXY('*', game.x, game.y);
-            Game_SetColor(BackgroundBlack);
-            Game_Bell();
-            if(game.health > 0) game.health--;
-            Task_Queue(UpdateHealth, 0);
-            Task_Schedule(ResetScreenColor, 0, 250, 0);
-        }
-        else {
-            Game_SetColor(ForegroundCyan);
-            Game_CharXY(game.c, game.x, game.y);
-            Game_SetColor(ForegroundWhite);
+        if(HasAsteroid(game.x, game.y)) { // moved into asteroid
+            SetAsteroid(game.x, game.y, NO_ASTEROID); // destroy asteroid
+            HitShip();
         }
+        else DrawShip();
     }
 }
 
@@ -638,9 +1043,80 @@ void Receiver(uint8_t c) {
         default:
             break;
     }
+    Commit(c == ' ' ? FRAME_SHOT : FRAME_MOVE);
+}
+
+/** @brief Send the frame and add its bytes to the report
+ *
+ * @param kind what the frame was drawn for
+ */
+void Commit(uint8_t kind) {
+    uint16_t size = Screen_Flush();
+    if(size == 0) return;
+    frameBytes[kind].bytes += size;
+    frameBytes[kind].frames++;
+    if(size > frameBytes[kind].largest) frameBytes[kind].largest = size;
+}
+
+/** @brief Log the bytes sent for each kind of frame and the spread of frame sizes
+ */
+void ReportBytes(void) {
+    volatile uint8_t i;
+    for(i = 0; i < FRAME_KINDS; i++) {
+        if(frameBytes[i].frames == 0) continue;
+        Game_Log(game.id, "%s: %u frames %lu bytes, %lu per frame, largest %u", frameNames[i], frameBytes[i].frames,
+                 frameBytes[i].bytes, frameBytes[i].bytes / frameBytes[i].frames, frameBytes[i].largest);
+    }
+    ReportPercentile(50);
+    ReportPercentile(99);
+}
+
+/** @brief Log the range of frame sizes a share of frames stays within
+ *
+ * @param percent share of frames, 50 for the median
+ */
+void ReportPercentile(uint8_t percent) {
+    uint16_t size = Screen_FramePercentile(percent);
+    if(size >= SCREEN_SIZE_OPEN) Game_Log(game.id, "frames: p%u %u bytes or more", percent, size);
+    else Game_Log(game.id, "frames: p%u %u to %u bytes", percent, size, size ? 2 * size - 1 : 0);
+}
+
+/** @brief Compare the time it takes to show numbers through Game_Printf and through the direct path
+ *
+ * Both paths get every number onto the terminal, so the time is measured
+ * on the millisecond clock and includes waiting for the UART: Game_Printf
+ * sends the position and every digit, the framebuffer only the digits that
+ * changed. It shows what each path costs on the link rather than in CPU
+ * cycles. Runs for a few hundred milliseconds, use it between games.
+ */
+void Bench(void) {
+    volatile uint16_t i;
+    tint_t start;
+    uint32_t printfTime, directTime;
+
+    start = TimeNow();
+    for(i = 0; i < BENCH_LOOPS; i++) {
+        Screen_Unsigned(0, BENCH_ROW, i);
+        Screen_FlushAll();
+    }
+    directTime = TimeSince(start);
+
+    // last so the terminal ends up showing the same number as the framebuffer
+    start = TimeNow();
+    for(i = 0; i < BENCH_LOOPS; i++) {
+        Game_CharXY('\r', 0, BENCH_ROW);
+        Game_Printf("%u", i);
+    }
+    printfTime = TimeSince(start);
+
+    Screen_Invalidate();
+    Screen_Text(0, BENCH_ROW, "   ");
+    Screen_FlushAll(); // put the row back the way it was
+    Game_Log(game.id, "ms for %u numbers: printf %lu direct %lu", BENCH_LOOPS, printfTime, directTime);
 }
 
 void Callback(int argc, char * argv[]) {
+    volatile uint8_t i;
     // "play" and "help" are called automatically so just process "reset" here
     if(argc == 0) Game_Log(game.id, "too few args");
     if(strcasecmp(argv[0],"reset") == 0) {
@@ -648,5 +1124,67 @@ void Callback(int argc, char * argv[]) {
         game.score = 0;
         Game_Log(game.id, "Scores reset");
     }
+    else if(strcasecmp(argv[0],"scroll") == 0) {
+        // pick how the terminal scrolls the asteroid field
+        if(argc < 2) Game_Log(game.id, "too few args");
+        else if(strcasecmp(argv[1],"redraw") == 0) Screen_SetScrollMode(SCREEN_SCROLL_REDRAW);
+        else if(strcasecmp(argv[1],"dch") == 0) Screen_SetScrollMode(SCREEN_SCROLL_DCH);
+        else if(strcasecmp(argv[1],"margins") == 0) Screen_SetScrollMode(SCREEN_SCROLL_MARGINS);
+        else Game_Log(game.id, "scroll mode not supported");
+    }
+    else if(strcasecmp(argv[0],"stats") == 0) {
+        // show how much the terminal output was held back
+        screen_stats_t stats;
+        Screen_GetStats(&stats);
+        Game_Log(game.id, "bytes %lu deferred %lu dropped %lu", stats.bytes, stats.deferred, stats.dropped);
+        Game_Log(game.id, "frames %lu largest %u bytes latency %u-%u us", stats.frames, stats.maxFrameBytes,
+                 stats.minLatency, stats.maxLatency);
+        Game_Log(game.id, "frames held %lu stalled %lu, queued up to %u bytes, held up to %u cells", stats.droppedFrames,
+                 stats.stalls, stats.highWater, stats.maxPending);
+    }
+    else if(strcasecmp(argv[0],"output") == 0) {
+        // terminal sequences or binary frames for the host client
+        if(argc < 2) Game_Log(game.id, "too few args");
+        else if(strcasecmp(argv[1],"ansi") == 0) Screen_SetOutputMode(SCREEN_OUTPUT_ANSI);
+        else if(strcasecmp(argv[1],"binary") == 0) Screen_SetOutputMode(SCREEN_OUTPUT_BINARY);
+        else Game_Log(game.id, "output mode not supported");
+    }
+    else if(strcasecmp(argv[0],"backpressure") == 0) {
+        // what to do when the UART falls behind
+        if(argc < 2) Game_Log(game.id, "too few args");
+        else if(strcasecmp(argv[1],"coalesce") == 0) Screen_SetBackpressure(SCREEN_BACKPRESSURE_COALESCE);
+        else if(strcasecmp(argv[1],"drop") == 0) Screen_SetBackpressure(SCREEN_BACKPRESSURE_DROP);
+        else if(strcasecmp(argv[1],"block") == 0) Screen_SetBackpressure(SCREEN_BACKPRESSURE_BLOCK);
+        else Game_Log(game.id, "backpressure mode not supported");
+    }
+    else if(strcasecmp(argv[0],"sync") == 0) {
+        // wrap each frame in a synchronized update
+        if(argc < 2) Game_Log(game.id, "too few args");
+        else if(strcasecmp(argv[1],"on") == 0) Screen_SetSyncUpdate(1);
+        else if(strcasecmp(argv[1],"off") == 0) Screen_SetSyncUpdate(0);
+        else Game_Log(game.id, "sync mode not supported");
+    }
+    else if(strcasecmp(argv[0],"bytes") == 0) {
+        // bytes sent for each kind of frame, "bytes reset" starts counting again
+        if(argc >= 2 && strcasecmp(argv[1],"reset") == 0) {
+            for(i = 0; i < FRAME_KINDS; i++) {
+                frameBytes[i].bytes = 0;
+                frameBytes[i].frames = 0;
+                frameBytes[i].largest = 0;
+            }
+            Screen_ResetStats();
+        }
+        else ReportBytes();
+    }
+    else if(strcasecmp(argv[0],"linktest") == 0) {
+        // measure the link, the screen paces itself to the result from now on
+        screen_link_t link;
+        Screen_LinkTest(&link);
+        Game_Log(game.id, "link %lu bytes/s, buffer drains at %lu bytes/s, waited %u ms for %u bytes",
+                 link.bytesPerSecond, link.drainRate, link.stall, link.bytes);
+    }
+    else if(strcasecmp(argv[0],"bench") == 0) Bench();
     else Game_Log(game.id, "command not supported");
+    // whatever was logged moved the cursor and may have changed the color
+    Screen_Invalidate();
 }
@@ -0,0 +1,96 @@
+/**
+ * @file task_handle.c
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Task handles on top of the library's task list
+ *
+ * The library only knows tasks by their function and pointer. Every task
+ * scheduled through a handle gets an entry of its own and the library runs
+ * Run() with that entry as the pointer, so no two of them ever match the
+ * same Task_Remove(). Cancelling still leaves the library to search its
+ * list, only the heap backend avoids that.
+ *
+ * The library does not say when a task did not fit in its list, the entry
+ * of such a task stays taken until it is cancelled.
+ */
+
+#include "project_settings.h"
+
+#if TASK_BACKEND == TASK_BACKEND_LIST
+
+#include "task.h"
+#include "task_handle.h"
+
+#if TASK_HANDLE_LENGTH > 255
+#error "task_handle.c numbers its entries with a byte"
+#endif
+
+#define HANDLE(i)                   ((task_handle_t)(((uint16_t)entries[i].generation << 8) | (i)))
+
+/// a task scheduled through a handle
+typedef struct {
+    task_t fn; ///< function to run
+    void * pointer; ///< passed to the function
+    tint_t period; ///< ms between runs, 0 to run once
+    uint8_t used; ///< entry holds a task
+    uint8_t generation; ///< bumped every time the entry is freed, never 0
+} entry_t;
+
+static entry_t entries[TASK_HANDLE_LENGTH];
+
+static void Run(entry_t * entry);
+static void Free(entry_t * entry);
+
+task_handle_t Task_ScheduleHandle(task_t fn, void * pointer, tint_t delay, tint_t period) {
+    uint8_t i;
+    unsigned short state;
+    TASK_HOLD_INTERRUPTS(state);
+    for(i = 0; i < TASK_HANDLE_LENGTH && entries[i].used; i++);
+    if(i == TASK_HANDLE_LENGTH) {
+        TASK_RESTORE_INTERRUPTS(state);
+        return TASK_NO_HANDLE;
+    }
+    if(entries[i].generation == 0) entries[i].generation = 1; // statics start out as 0
+    entries[i].fn = fn;
+    entries[i].pointer = pointer;
+    entries[i].period = period;
+    entries[i].used = 1;
+    Task_Schedule((task_t)Run, &entries[i], delay, period);
+    TASK_RESTORE_INTERRUPTS(state);
+    return HANDLE(i);
+}
+
+task_handle_t Task_QueueHandle(task_t fn, void * pointer) {
+    return Task_ScheduleHandle(fn, pointer, 0, 0);
+}
+
+void Task_Cancel(task_handle_t handle) {
+    uint8_t i = handle & 0xFF;
+    unsigned short state;
+    if(i >= TASK_HANDLE_LENGTH) return;
+    TASK_HOLD_INTERRUPTS(state);
+    // the generation no longer matches once the task ran for the last time or was cancelled
+    if(entries[i].used && HANDLE(i) == handle) {
+        Task_Remove((task_t)Run, &entries[i]);
+        Free(&entries[i]);
+    }
+    TASK_RESTORE_INTERRUPTS(state);
+}
+
+/** @brief Run the task of an entry, the entry is free again once a task that runs once has run
+ */
+void Run(entry_t * entry) {
+    task_t fn = entry->fn;
+    void * pointer = entry->pointer;
+    if(entry->period == 0) Free(entry);
+    ((void(*)(void *))fn)(pointer);
+}
+
+/** @brief Free an entry so handles to it no longer match
+ */
+void Free(entry_t * entry) {
+    entry->used = 0;
+    if(++entry->generation == 0) entry->generation = 1;
+}
+
+#endif // TASK_BACKEND == TASK_BACKEND_LIST
@@ -0,0 +1,72 @@
+/**
+ * @file task_handle.h
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Schedule tasks and cancel them through a handle instead of by function and pointer
+ *
+ * Task_Remove() has to search for a task by its function and pointer and
+ * removes every task that matches. A handle names exactly one scheduled
+ * task and carries the generation of the slot it was given, so once the
+ * task ran for the last time or was cancelled the handle no longer matches
+ * anything, even after the slot is reused.
+ *
+ * With TASK_BACKEND_HEAP these are part of task_heap.c and cancelling takes
+ * O(log n). With the library's list task_handle.c wraps every task in an
+ * entry of its own so it can still tell them apart, but the library has to
+ * search its list to remove it.
+ */
+
+#ifndef TASK_HANDLE_H_
+#define TASK_HANDLE_H_
+
+#include "project_settings.h"
+#include "task.h"
+
+#define TASK_NO_HANDLE              0               // no task, cancelling it does nothing
+
+// Tasks that can hold a handle at once with the library's list, the heap gives every task one
+#ifndef TASK_HANDLE_LENGTH
+#define TASK_HANDLE_LENGTH          8
+#endif
+
+/// slot in the low byte and the slot's generation in the high byte, generations start at 1
+typedef uint16_t task_handle_t;
+
+// Task lists are changed from interrupts too, keep them out while one is rearranged
+#ifdef __MSP430__
+#include <msp430.h>
+#define TASK_HOLD_INTERRUPTS(state) do { state = __get_interrupt_state(); __disable_interrupt(); } while(0)
+#define TASK_RESTORE_INTERRUPTS(state) __set_interrupt_state(state)
+#else // nothing interrupts a host build
+#define TASK_HOLD_INTERRUPTS(state) (state = 0)
+#define TASK_RESTORE_INTERRUPTS(state) ((void)(state))
+#endif
+
+/** Schedule a task like Task_Schedule() and return a handle to cancel it with
+ *
+ * @param fn function to run, called with pointer
+ * @param pointer passed to fn
+ * @param delay ms until the first run
+ * @param period ms between runs, 0 to run once
+ * @return handle of the task, TASK_NO_HANDLE when it did not fit
+ */
+task_handle_t Task_ScheduleHandle(task_t fn, void * pointer, tint_t delay, tint_t period);
+
+/** Queue a task to run once as soon as possible like Task_Queue()
+ *
+ * @param fn function to run, called with pointer
+ * @param pointer passed to fn
+ * @return handle of the task, TASK_NO_HANDLE when it did not fit
+ */
+task_handle_t Task_QueueHandle(task_t fn, void * pointer);
+
+/** Cancel a task scheduled with Task_ScheduleHandle() or Task_QueueHandle()
+ *
+ * Does nothing for TASK_NO_HANDLE or when the task already ran for the last
+ * time or was cancelled.
+ *
+ * @param handle of the task
+ */
+void Task_Cancel(task_handle_t handle);
+
+#endif /* TASK_HANDLE_H_ */
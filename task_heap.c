@@ -0,0 +1,211 @@
+/**
+ * @file task_heap.c
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Binary min-heap scheduler in place of the library's task list
+ *
+ * Tasks live in a fixed pool of TASK_MAX_LENGTH slots. The heap holds slot
+ * numbers ordered by the time each task runs next and every slot remembers
+ * where it sits in the heap, so a task can be taken out of the middle
+ * without looking for it. The task that is due first is always on top and
+ * SystemTick() stops at the first one that is not due yet.
+ *
+ * Times are compared by their difference so the order holds when the
+ * millisecond counter wraps, as long as no task is scheduled more than
+ * about 24 days ahead.
+ *
+ * Tasks can be scheduled and removed from interrupts, so the heap is only
+ * rearranged with interrupts held off. They are back on while a task runs.
+ */
+
+#include "project_settings.h"
+
+#if TASK_BACKEND == TASK_BACKEND_HEAP
+
+#include "task.h"
+#include "timing.h"
+#include "task_handle.h"
+#include "task_heap.h"
+
+#if TASK_MAX_LENGTH > 255
+#error "task_heap.c numbers its slots with a byte and keeps 255 to mark a free slot"
+#endif
+
+#define FREE_SLOT                   255             // position of a slot that holds no task
+#define PARENT(i)                   (((i) - 1) >> 1)
+#define LEFT(i)                     (((i) << 1) + 1)
+#define DUE_BEFORE(a, b)            ((int32_t)(slots[a].next - slots[b].next) < 0)
+#define HANDLE(slot)                ((task_handle_t)(((uint16_t)slots[slot].generation << 8) | (slot)))
+
+/// a task and where it sits in the heap
+typedef struct {
+    task_t fn; ///< function to run
+    void * pointer; ///< passed to the function
+    tint_t next; ///< time it runs next
+    tint_t period; ///< ms between runs, 0 to run once
+    uint8_t position; ///< index in the heap, FREE_SLOT when unused
+    uint8_t generation; ///< bumped every time the slot is reused, never 0
+} slot_t;
+
+static slot_t slots[TASK_MAX_LENGTH];
+static uint8_t heap[TASK_MAX_LENGTH]; ///< slots ordered by the time they run next
+static uint8_t count; ///< tasks in the heap
+static uint8_t freeSlots[TASK_MAX_LENGTH]; ///< stack of unused slots
+static uint8_t freeCount; ///< slots on the stack
+static uint16_t overflow; ///< tasks that did not fit
+
+static void Place(uint8_t i, uint8_t slot);
+static void SiftUp(uint8_t i);
+static void SiftDown(uint8_t i);
+static void RemoveAt(uint8_t i);
+
+void Task_Init(void) {
+    uint8_t i;
+    count = 0;
+    overflow = 0;
+    for(i = 0; i < TASK_MAX_LENGTH; i++) {
+        slots[i].position = FREE_SLOT;
+        slots[i].generation = 1;
+        freeSlots[i] = TASK_MAX_LENGTH - 1 - i;
+    }
+    freeCount = TASK_MAX_LENGTH;
+}
+
+void Task_Schedule(task_t fn, void * pointer, tint_t delay, tint_t period) {
+    Task_ScheduleHandle(fn, pointer, delay, period);
+}
+
+void Task_Queue(task_t fn, void * pointer) {
+    Task_ScheduleHandle(fn, pointer, 0, 0);
+}
+
+void Task_Remove(task_t fn, void * pointer) {
+    uint8_t slot;
+    unsigned short state;
+    TASK_HOLD_INTERRUPTS(state);
+    // walk the slots rather than the heap, taking a task out rearranges the heap but never moves a slot
+    for(slot = 0; slot < TASK_MAX_LENGTH; slot++) {
+        if(slots[slot].position != FREE_SLOT && slots[slot].fn == fn && slots[slot].pointer == pointer) {
+            RemoveAt(slots[slot].position);
+        }
+    }
+    TASK_RESTORE_INTERRUPTS(state);
+}
+
+void SystemTick(void) {
+    uint8_t slot, runs;
+    task_t fn;
+    void * pointer;
+    unsigned short state;
+    // like the library's walk of the list a task runs at most once per call, even if it is behind by more than a period
+    for(runs = count; runs; runs--) {
+        TASK_HOLD_INTERRUPTS(state);
+        if(count == 0 || (int32_t)(TimeNow() - slots[heap[0]].next) < 0) {
+            TASK_RESTORE_INTERRUPTS(state);
+            return;
+        }
+        slot = heap[0];
+        fn = slots[slot].fn;
+        pointer = slots[slot].pointer;
+        if(slots[slot].period) {
+            slots[slot].next += slots[slot].period;
+            SiftDown(0);
+        }
+        else RemoveAt(0);
+        TASK_RESTORE_INTERRUPTS(state);
+        ((void(*)(void *))fn)(pointer);
+    }
+}
+
+task_handle_t Task_ScheduleHandle(task_t fn, void * pointer, tint_t delay, tint_t period) {
+    uint8_t slot;
+    unsigned short state;
+    TASK_HOLD_INTERRUPTS(state);
+    if(freeCount == 0) {
+        overflow++;
+        TASK_RESTORE_INTERRUPTS(state);
+        return TASK_NO_HANDLE;
+    }
+    slot = freeSlots[--freeCount];
+    slots[slot].fn = fn;
+    slots[slot].pointer = pointer;
+    slots[slot].next = TimeNow() + delay;
+    slots[slot].period = period;
+    Place(count, slot);
+    SiftUp(count++);
+    TASK_RESTORE_INTERRUPTS(state);
+    return HANDLE(slot);
+}
+
+task_handle_t Task_QueueHandle(task_t fn, void * pointer) {
+    return Task_ScheduleHandle(fn, pointer, 0, 0);
+}
+
+void Task_Cancel(task_handle_t handle) {
+    uint8_t slot = handle & 0xFF;
+    unsigned short state;
+    if(slot >= TASK_MAX_LENGTH) return;
+    TASK_HOLD_INTERRUPTS(state);
+    // the generation no longer matches once the task ran for the last time or the slot was reused
+    // taken out right away rather than skipped once due, so cancelled tasks never hold on to the fixed pool
+    if(slots[slot].position != FREE_SLOT && HANDLE(slot) == handle) RemoveAt(slots[slot].position);
+    TASK_RESTORE_INTERRUPTS(state);
+}
+
+uint8_t TaskHeap_Count(void) {
+    return count;
+}
+
+uint16_t TaskHeap_Overflow(void) {
+    return overflow;
+}
+
+/** @brief Put a slot at a position of the heap and let the slot know where it is
+ */
+void Place(uint8_t i, uint8_t slot) {
+    heap[i] = slot;
+    slots[slot].position = i;
+}
+
+/** @brief Move the task at a position up until its parent is not due after it
+ */
+void SiftUp(uint8_t i) {
+    uint8_t slot = heap[i];
+    while(i && DUE_BEFORE(slot, heap[PARENT(i)])) {
+        Place(i, heap[PARENT(i)]);
+        i = PARENT(i);
+    }
+    Place(i, slot);
+}
+
+/** @brief Move the task at a position down until neither child is due before it
+ */
+void SiftDown(uint8_t i) {
+    uint8_t slot = heap[i], child;
+    while(LEFT(i) < count) {
+        child = LEFT(i);
+        if(child + 1 < count && DUE_BEFORE(heap[child + 1], heap[child])) child++;
+        if(!DUE_BEFORE(heap[child], slot)) break;
+        Place(i, heap[child]);
+        i = child;
+    }
+    Place(i, slot);
+}
+
+/** @brief Take the task at a position out of the heap and free its slot
+ */
+void RemoveAt(uint8_t i) {
+    uint8_t slot = heap[i];
+    count--;
+    if(i < count) {
+        // the last task fills the hole and moves whichever way keeps the order
+        Place(i, heap[count]);
+        if(i && DUE_BEFORE(heap[i], heap[PARENT(i)])) SiftUp(i);
+        else SiftDown(i);
+    }
+    slots[slot].position = FREE_SLOT;
+    if(++slots[slot].generation == 0) slots[slot].generation = 1;
+    freeSlots[freeCount++] = slot;
+}
+
+#endif // TASK_BACKEND == TASK_BACKEND_HEAP
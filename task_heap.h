@@ -0,0 +1,32 @@
+/**
+ * @file task_heap.h
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Scheduler backend keeping the tasks in a binary min-heap
+ *
+ * Built in place of the library's task.c when TASK_BACKEND is
+ * TASK_BACKEND_HEAP, see project_settings.h. Task_Schedule(), Task_Queue(),
+ * Task_Remove() and SystemTick() behave like the library's so callers do
+ * not change. SystemTick() only looks at the tasks that are due and
+ * scheduling takes O(log n) instead of a walk of the whole list.
+ * Task_Remove() still has to find the task by its function and pointer,
+ * a handle from Task_ScheduleHandle() cancels it in O(log n), see
+ * task_handle.h.
+ */
+
+#ifndef TASK_HEAP_H_
+#define TASK_HEAP_H_
+
+#include "project_settings.h"
+#include "task.h"
+#include "task_handle.h"
+
+/** Number of tasks scheduled
+ */
+uint8_t TaskHeap_Count(void);
+
+/** Number of tasks that did not fit since Task_Init()
+ */
+uint16_t TaskHeap_Overflow(void);
+
+#endif /* TASK_HEAP_H_ */
@@ -0,0 +1,123 @@
+/**
+ * @file bench_tasks.c
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Time scheduling and cancelling timers on either scheduler backend
+ *
+ * Built once against the model of the library's task list and once
+ * against task_heap.c for every number of tasks, see the Makefile. Every
+ * timer stays scheduled for the whole run like shots flying across the
+ * field: a one-shot timer schedules itself again when it runs and a few
+ * random timers are cancelled and scheduled again every ms. The list
+ * cancels with Task_Remove(), the heap with the handle it handed out.
+ *
+ * Time here is simulated and only moves once per ms of the run, the
+ * nanoseconds are measured on the host clock.
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include "project_settings.h"
+#include "task.h"
+#include "timing.h"
+#if TASK_BACKEND == TASK_BACKEND_HEAP
+#include "task_handle.h"
+#define BACKEND                     "heap"
+#else
+#define BACKEND                     "list"
+#endif
+
+#define BENCH_TIME                  10000           // simulated ms
+#define CHURN                       4               // timers cancelled and scheduled again every ms
+#define MAX_DELAY                   500             // ms a timer is scheduled ahead at most
+
+static tint_t now; ///< simulated time
+static uint8_t timers[TASK_MAX_LENGTH]; ///< only their addresses are used, as the task pointers
+#if TASK_BACKEND == TASK_BACKEND_HEAP
+static task_handle_t handles[TASK_MAX_LENGTH];
+#endif
+static uint32_t ran; ///< timers that ran
+static uint32_t scheduled; ///< timers scheduled in total
+static uint32_t seed = 1; ///< of the random delays
+
+static void Fire(void * timer);
+static void Arm(uint8_t i);
+static void Cancel(uint8_t i);
+static uint32_t Random(void);
+static double Now(void);
+
+int main(void) {
+    double start, churn = 0, tick = 0;
+    uint8_t i, c;
+
+    Task_Init();
+    for(i = 0; i < TASK_MAX_LENGTH; i++) Arm(i);
+    for(now = 0; now < BENCH_TIME; now++) {
+        start = Now();
+        for(c = 0; c < CHURN; c++) {
+            i = Random() % TASK_MAX_LENGTH;
+            Cancel(i);
+            Arm(i);
+        }
+        churn += Now() - start;
+        start = Now();
+        SystemTick();
+        tick += Now() - start;
+    }
+    printf("%s %3d tasks %6.0f ns per cancel and schedule %7.0f ns per SystemTick, %u scheduled %u ran\n", BACKEND,
+           TASK_MAX_LENGTH, churn / (BENCH_TIME * CHURN), tick / BENCH_TIME, scheduled, ran);
+    return 0;
+}
+
+/** @brief Run a timer, a one-shot timer is scheduled again so it stays in the list
+ */
+void Fire(void * timer) {
+    uint8_t i = (uint8_t *)timer - timers;
+    ran++;
+    if(i & 3) Arm(i);
+}
+
+/** @brief Schedule a timer, one in four is periodic
+ */
+void Arm(uint8_t i) {
+    tint_t delay = 1 + Random() % MAX_DELAY, period = (i & 3) ? 0 : 10 + Random() % 90;
+    scheduled++;
+#if TASK_BACKEND == TASK_BACKEND_HEAP
+    handles[i] = Task_ScheduleHandle((task_t)Fire, &timers[i], delay, period);
+#else
+    Task_Schedule((task_t)Fire, &timers[i], delay, period);
+#endif
+}
+
+/** @brief Cancel a timer whether or not it already ran
+ */
+void Cancel(uint8_t i) {
+#if TASK_BACKEND == TASK_BACKEND_HEAP
+    Task_Cancel(handles[i]);
+#else
+    Task_Remove((task_t)Fire, &timers[i]);
+#endif
+}
+
+/** @brief Same generator on every backend so they see the same delays
+ */
+uint32_t Random(void) {
+    seed = seed * 1103515245 + 12345;
+    return seed >> 16;
+}
+
+/** @brief Host clock in ns
+ */
+double Now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+tint_t TimeNow(void) {
+    return now;
+}
+
+tint_t TimeSince(tint_t t) {
+    return now - t;
+}
@@ -0,0 +1,368 @@
+/**
+ * @file host.c
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Host stand-ins for the embedded-software library and the run driver
+ *
+ * The UART is a transmit ring of HOST_TX_BUFFER_LENGTH bytes that drains
+ * at HOST_LINK_RATE. Writes never wait, the bytes that would have had to
+ * wait for room are counted instead and the ring is left full as if they
+ * had. The game runs the same no matter how much it sends. That keeps runs of different output strategies
+ * comparable cell for cell.
+ *
+ * A game that keeps asking whether the UART is still sending, without
+ * writing anything in between, is busy waiting on it. After POLLS_PER_MS
+ * such calls a ms passes and the ring drains, without running any tasks,
+ * just like on the target.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "game.h"
+#include "random_int.h"
+#include "task.h"
+#include "timing.h"
+#include "uart.h"
+#include "host.h"
+
+#define MAX_ARGS                    4               // words in a game command
+#define COMMAND_LENGTH              64              // characters in a game command
+#define POLLS_PER_MS                1000            // times the UART is asked if it is sending before a ms passes
+
+void StephenGame_Init(void);
+
+static tint_t now; ///< ms since the start
+static uint32_t seed; ///< state of the random numbers
+static uint32_t ring; ///< bytes queued for the UART
+static uint32_t drainCredit; ///< bytes the link sent in the current ms, times 1000
+static uint16_t polls; ///< times the UART was asked if it is sending since the last write
+static uint8_t context = HOST_OTHER; ///< what the game is doing
+static host_result_t result; ///< counters of the run
+static uint32_t tickBytes; ///< bytes sent since the last tick sample
+static tint_t playStart; ///< time the game started
+static uint8_t playing; ///< game started and not over yet
+static host_sink_t sink; ///< where else the output goes
+
+static void (*play)(void);
+static void (*callback)(int argc, char * argv[]);
+static void (*receiver)(uint8_t c);
+
+static void Send(const char * data, uint16_t length);
+static void SendFormat(const char * str, va_list vars);
+static void DrainRing(uint32_t ms);
+static void AddSample(uint8_t event, uint32_t bytes);
+
+void Host_Init(uint32_t s) {
+    now = 0;
+    seed = s;
+    ring = 0;
+    drainCredit = 0;
+    polls = 0;
+    context = HOST_OTHER;
+    memset(&result, 0, sizeof(result));
+    tickBytes = 0;
+    playing = 0;
+    Task_Init();
+    StephenGame_Init();
+}
+
+void Host_SetSink(host_sink_t s) {
+    sink = s;
+}
+
+void Host_Command(const char * line) {
+    char copy[COMMAND_LENGTH];
+    char * argv[MAX_ARGS];
+    int argc = 0;
+    char * word;
+    strncpy(copy, line, sizeof(copy) - 1);
+    copy[sizeof(copy) - 1] = 0;
+    for(word = strtok(copy, " "); word && argc < MAX_ARGS; word = strtok(0, " ")) argv[argc++] = word;
+    if(argc == 0 || callback == 0) return;
+    context = HOST_OTHER;
+    callback(argc, argv);
+}
+
+void Host_Play(void) {
+    context = HOST_PLAY;
+    play();
+    context = HOST_OTHER;
+    playStart = now;
+    playing = 1;
+}
+
+void Host_Key(char c) {
+    uint32_t before;
+    uint8_t event = c == ' ' ? HOST_SHOOT : HOST_MOVE;
+    if(receiver == 0) return;
+    context = event;
+    before = result.bytes[event];
+    receiver(c);
+    context = HOST_OTHER;
+    AddSample(event, result.bytes[event] - before);
+}
+
+void Host_Advance(uint32_t ms) {
+    uint32_t before;
+    for(; ms > 0; ms--) {
+        now++;
+        DrainRing(1);
+        context = HOST_TICK_EVENT;
+        before = result.bytes[HOST_TICK_EVENT];
+        SystemTick();
+        context = HOST_OTHER;
+        tickBytes += result.bytes[HOST_TICK_EVENT] - before;
+        if(TaskList_Count() > result.tasksMax) result.tasksMax = TaskList_Count();
+        // retries and anything else between two ticks count with the tick that follows
+        if(playing && (now - playStart) % HOST_TICK == 0) {
+            AddSample(HOST_TICK_EVENT, tickBytes);
+            tickBytes = 0;
+        }
+    }
+}
+
+uint8_t Host_GameOver(void) {
+    return result.over;
+}
+
+void Host_Run(const host_run_t * run) {
+    char line[COMMAND_LENGTH];
+    const char * c;
+    size_t length = 0;
+    uint32_t key = 0, t;
+    // commands are sent one by one as they are found between the separators
+    for(c = run->setup; c; c++) {
+        if(*c == ';' || *c == 0) {
+            line[length] = 0;
+            Host_Command(line);
+            length = 0;
+            if(*c == 0) break;
+        }
+        else if(length < sizeof(line) - 1) line[length++] = *c;
+    }
+    Host_Play();
+    for(t = 1; t <= run->ms && !result.over; t++) {
+        Host_Advance(1);
+        if(t % HOST_KEY_PERIOD == 0 && run->keys && run->keys[0]) {
+            Host_Key(run->keys[key++ % strlen(run->keys)]);
+        }
+    }
+}
+
+void Host_GetResult(host_result_t * r) {
+    uint8_t i;
+    *r = result;
+    r->ms = now - playStart;
+    r->taskOverflow = TaskList_Overflow();
+    for(i = 0; i < HOST_EVENTS; i++) Host_Spread(result.histogram[i], &r->spread[i]);
+}
+
+void Host_Spread(const uint32_t * histogram, host_spread_t * spread) {
+    uint32_t bytes, counted = 0;
+    memset(spread, 0, sizeof(*spread));
+    for(bytes = 0; bytes < HOST_HISTOGRAM; bytes++) {
+        spread->count += histogram[bytes];
+        spread->bytes += histogram[bytes] * bytes;
+    }
+    // nearest rank, the smallest size that share of the events stays within
+    for(bytes = 0; bytes < HOST_HISTOGRAM; bytes++) {
+        if(histogram[bytes] == 0) continue;
+        if(counted * 100 < spread->count * 50) spread->p50 = bytes;
+        if(counted * 100 < spread->count * 99) spread->p99 = bytes;
+        counted += histogram[bytes];
+        spread->max = bytes;
+    }
+}
+
+int Host_Isolate(void (*fn)(void * arg, void * result), void * arg, void * r, size_t size) {
+    int fds[2], status;
+    pid_t pid;
+    size_t got = 0;
+    ssize_t n;
+    fflush(stdout);
+    fflush(stderr);
+    if(pipe(fds) != 0) return -1;
+    pid = fork();
+    if(pid < 0) return -1;
+    if(pid == 0) {
+        close(fds[0]);
+        fn(arg, r);
+        while(got < size && (n = write(fds[1], (char *)r + got, size - got)) > 0) got += n;
+        _exit(got == size ? 0 : 1);
+    }
+    close(fds[1]);
+    while(got < size && (n = read(fds[0], (char *)r + got, size - got)) > 0) got += n;
+    close(fds[0]);
+    if(waitpid(pid, &status, 0) != pid) return -1;
+    if(got != size || !WIFEXITED(status) || WEXITSTATUS(status) != 0) return -1;
+    return 0;
+}
+
+/** @brief Hand bytes to the ring model and count them for the current event
+ */
+void Send(const char * data, uint16_t length) {
+    polls = 0;
+    result.bytes[context] += length;
+    ring += length;
+    if(ring > HOST_TX_BUFFER_LENGTH) {
+        // the part that does not fit would have waited for the UART, which leaves the ring full
+        result.overrun[context] += ring - HOST_TX_BUFFER_LENGTH < length ? ring - HOST_TX_BUFFER_LENGTH : length;
+        ring = HOST_TX_BUFFER_LENGTH;
+    }
+    if(ring > result.ringMax) result.ringMax = ring;
+    if(sink) sink((const uint8_t *)data, length);
+}
+
+/** @brief Format text and send it
+ */
+void SendFormat(const char * str, va_list vars) {
+    char text[256];
+    int n = vsnprintf(text, sizeof(text), str, vars);
+    if(n < 0) return;
+    if(n >= (int)sizeof(text)) n = sizeof(text) - 1;
+    Send(text, n);
+}
+
+/** @brief Take what the link sent out of the ring
+ *
+ * @param ms time that passed
+ */
+void DrainRing(uint32_t ms) {
+    uint32_t sent;
+    drainCredit += ms * HOST_LINK_RATE;
+    sent = drainCredit / 1000;
+    drainCredit %= 1000;
+    if(sent >= ring) {
+        ring = 0;
+        drainCredit = 0; // an idle link does not save up time
+    }
+    else ring -= sent;
+}
+
+/** @brief Count the bytes of one event
+ */
+void AddSample(uint8_t event, uint32_t bytes) {
+    result.histogram[event][bytes < HOST_HISTOGRAM ? bytes : HOST_HISTOGRAM - 1]++;
+}
+
+tint_t TimeNow(void) {
+    return now;
+}
+
+tint_t TimeSince(tint_t t) {
+    return now - t;
+}
+
+int16_t random_int(int16_t min, int16_t max) {
+    seed = seed * 1103515245u + 12345u;
+    return min + (int16_t)((seed >> 16) % (uint32_t)(max - min + 1));
+}
+
+void UART_WriteByte(uint8_t channel, char c) {
+    Send(&c, 1);
+}
+
+void UART_Write(uint8_t channel, char * data, uint16_t length) {
+    Send(data, length);
+}
+
+void UART_printf(uint8_t channel, char * str, ...) {
+    va_list vars;
+    va_start(vars, str);
+    SendFormat(str, vars);
+    va_end(vars);
+}
+
+uint8_t UART_IsTransmitting(uint8_t channel) {
+    // asked over and over with nothing written in between, the game is waiting on the UART and time goes on
+    if(ring && ++polls >= POLLS_PER_MS) {
+        polls = 0;
+        now++;
+        DrainRing(1);
+    }
+    return ring > 0;
+}
+
+void UART_ReconfigureBaud(uint8_t channel, uint32_t baud) {
+}
+
+uint8_t Game_Register(char * name, char * description, void(*p)(void), void(*help)(void)) {
+    play = p;
+    return 1;
+}
+
+void Game_RegisterCallback(uint8_t id, void(*c)(int argc, char * argv[])) {
+    callback = c;
+}
+
+void Game_CharXY(char c, char x, char y) {
+    char text[16];
+    int n = snprintf(text, sizeof(text), "\x1B[%d;%dH%c", y + 1, x + 1, c);
+    Send(text, n);
+}
+
+void Game_Printf(char * str, ...) {
+    va_list vars;
+    va_start(vars, str);
+    SendFormat(str, vars);
+    va_end(vars);
+}
+
+void Game_SetColor(enum term_color color) {
+    char text[8];
+    int n = snprintf(text, sizeof(text), "\x1B[%dm", color);
+    Send(text, n);
+}
+
+void Game_ClearScreen(void) {
+    Send("\x1B[2J", 4);
+}
+
+void Game_DrawRect(char x_min, char y_min, char x_max, char y_max) {
+    int i;
+    for(i = x_min; i <= x_max; i++) {
+        Game_CharXY('#', i, y_min);
+        Game_CharXY('#', i, y_max);
+    }
+    for(i = y_min; i <= y_max; i++) {
+        Game_CharXY('#', x_min, i);
+        Game_CharXY('#', x_max, i);
+    }
+}
+
+void Game_HideCursor(void) {
+    Send("\x1B[?25l", 6);
+}
+
+void Game_ShowCursor(void) {
+    Send("\x1B[?25h", 6);
+}
+
+void Game_Bell(void) {
+    Send("\a", 1);
+}
+
+void Game_GameOver(void) {
+    result.over = 1;
+    playing = 0;
+}
+
+void Game_RegisterPlayer1Receiver(void(*rx)(uint8_t c)) {
+    receiver = rx;
+}
+
+void Game_UnregisterPlayer1Receiver(void(*rx)(uint8_t c)) {
+    if(receiver == rx) receiver = 0;
+}
+
+void Game_Log(uint8_t id, char * str, ...) {
+    va_list vars;
+    va_start(vars, str);
+    vfprintf(stderr, str, vars);
+    fputc('\n', stderr);
+    va_end(vars);
+}
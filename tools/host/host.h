@@ -0,0 +1,147 @@
+/**
+ * @file host.h
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Runs the game on the host against stand-ins for the embedded-software library
+ *
+ * Time only moves when the harness advances it or the game busy waits on
+ * the UART, random numbers come from a fixed seed and keys are pressed from
+ * a script, so a run is the same every time. Output goes through a model of the UART transmit ring that drains
+ * at GAME_UART_BAUD and counts the bytes sent for each kind of event.
+ *
+ * The game and the screen keep their state in statics, so every run that
+ * has to start from scratch goes through Host_Isolate().
+ */
+
+#ifndef HOST_H_
+#define HOST_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define HOST_KEY_PERIOD             137             // ms between scripted key presses
+#define HOST_TICK                   25              // ms per game tick, same as GAME_TICK
+#define HOST_TX_BUFFER_LENGTH       512             // UART transmit ring, same as UART0_TX_BUFFER_LENGTH
+#define HOST_LINK_RATE              46080           // bytes per second the ring drains at, GAME_UART_BAUD / 10
+#define HOST_HISTOGRAM              4096            // bytes per event counted exactly, the last bin takes anything larger
+
+// What the game was doing when it sent a byte
+#define HOST_PLAY                   0               // starting the game
+#define HOST_TICK_EVENT             1               // anything run from the task list
+#define HOST_MOVE                   2               // handling a move key
+#define HOST_SHOOT                  3               // handling the fire key
+#define HOST_OTHER                  4               // commands and anything after the run
+#define HOST_EVENTS                 5
+
+/// Spread of the bytes sent per event
+typedef struct {
+    uint32_t count; ///< events
+    uint32_t bytes; ///< bytes sent for all of them
+    uint16_t p50; ///< median bytes per event
+    uint16_t p99; ///< 99th percentile bytes per event
+    uint16_t max; ///< most bytes for a single event
+} host_spread_t;
+
+/// What a run did
+typedef struct {
+    uint32_t ms; ///< time played
+    uint8_t over; ///< game ended before the time was up
+    uint32_t bytes[HOST_EVENTS]; ///< bytes sent by each kind of event
+    uint32_t overrun[HOST_EVENTS]; ///< bytes written while the transmit ring was full, the UART would have blocked
+    host_spread_t spread[HOST_EVENTS]; ///< per event, ticks are counted every HOST_TICK ms
+    uint32_t histogram[HOST_EVENTS][HOST_HISTOGRAM]; ///< events by bytes sent, to add up several runs
+    uint16_t ringMax; ///< most bytes queued at once
+    uint8_t tasksMax; ///< most tasks in the list at once
+    uint16_t taskOverflow; ///< tasks that did not fit in the list
+} host_result_t;
+
+/// A scripted run
+typedef struct {
+    uint32_t seed; ///< seed of the random numbers
+    uint32_t ms; ///< time to play for at most
+    const char * keys; ///< keys pressed in turn every HOST_KEY_PERIOD ms, spaces fire
+    const char * setup; ///< game commands to send before playing, separated by ';' like "scroll dch;sync on"
+} host_run_t;
+
+/// Where the bytes sent by the game go besides the ring model
+typedef void (*host_sink_t)(const uint8_t * data, uint16_t length);
+
+/** Load the game and start counting from zero
+ *
+ * @param seed seed of the random numbers
+ */
+void Host_Init(uint32_t seed);
+
+/** Send every byte the game writes to a function as well
+ *
+ * @param sink function to call, 0 for none
+ */
+void Host_SetSink(host_sink_t sink);
+
+/** Run a game command the way the shell would
+ *
+ * @param line command and arguments separated by spaces like "scroll dch"
+ */
+void Host_Command(const char * line);
+
+/** Start the game
+ */
+void Host_Play(void);
+
+/** Press a key
+ *
+ * @param c key to press
+ */
+void Host_Key(char c);
+
+/** Let time pass, running the task list once for every ms
+ *
+ * @param ms time to pass
+ */
+void Host_Advance(uint32_t ms);
+
+/** Check if the game has ended
+ */
+uint8_t Host_GameOver(void);
+
+/** Set up, play and press keys as a run describes
+ *
+ * Stops early when the game ends. Nothing is flushed at the end so cells
+ * held back over budget are still held back.
+ *
+ * @param run what to do
+ */
+void Host_Run(const host_run_t * run);
+
+/** Fill in the counters of everything since Host_Init()
+ *
+ * @param result where to put them
+ */
+void Host_GetResult(host_result_t * result);
+
+/** Work out the spread of bytes per event from a histogram
+ *
+ * @param histogram events by bytes sent
+ * @param spread where to put the result
+ */
+void Host_Spread(const uint32_t * histogram, host_spread_t * spread);
+
+/** Run a function in a fresh copy of the process
+ *
+ * Statics of the game start over for every call and the function can not
+ * disturb the caller. The function fills in a result of a fixed size which
+ * is copied back.
+ *
+ * @param fn function to run
+ * @param arg passed on to fn
+ * @param result where fn puts its result, copied back to the caller
+ * @param size bytes in the result
+ * @return 0 if the function returned normally
+ */
+int Host_Isolate(void (*fn)(void * arg, void * result), void * arg, void * result, size_t size);
+
+// Model of the library's task list, see task_list.c, or the heap scheduler through task_heap_hooks.c
+uint8_t TaskList_Count(void);
+uint16_t TaskList_Overflow(void);
+
+#endif /* HOST_H_ */
@@ -0,0 +1,108 @@
+/**
+ * @file report.c
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Compare the ways the screen can be sent on the same scripted games
+ *
+ * Every strategy plays the same seeds with the same keys, so the games are
+ * identical and only the output differs. Bytes are added up over all runs
+ * and the spread per tick and per key is taken over every event of every
+ * run. Built once with the default spawn rate and once with a busy field,
+ * see the Makefile.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "host.h"
+#include "screen.h"
+
+#ifndef STARTING_DIFFICULTY
+#define STARTING_DIFFICULTY         24              // same as stephen_game.c
+#endif
+
+#define SEEDS                       5               // runs of each strategy
+#define RUN_TIME                    60000           // ms each run plays for at most
+#define KEYS                        "wd sd wwaa ss  d w s"
+
+/// a way of sending the screen and the commands that select it
+typedef struct {
+    const char * name;
+    const char * setup;
+} strategy_t;
+
+/// what a run sends back
+typedef struct {
+    host_result_t host;
+    screen_stats_t screen;
+} run_result_t;
+
+static const strategy_t strategies[] = {
+    {"redraw", "scroll redraw"},
+    {"dch", "scroll dch"},
+    {"margins", "scroll margins"},
+    {"binary", "output binary"},
+    {"sync", "sync on"},
+};
+#define STRATEGIES                  (sizeof(strategies) / sizeof(strategies[0]))
+
+static run_result_t runResult; ///< too large for the stack
+
+static void Play(void * arg, void * result);
+
+int main(void) {
+    static uint32_t histogram[HOST_EVENTS][HOST_HISTOGRAM];
+    host_run_t run = {0, RUN_TIME, KEYS, 0};
+    host_spread_t tick, move, shoot;
+    uint32_t bytes, baseline = 0, deferred, overrun, played;
+    uint8_t s, seed, e;
+    uint32_t b;
+
+    printf("spawn 1 in %d, %d seeds of up to %d s, a key every %d ms\n", STARTING_DIFFICULTY, SEEDS, RUN_TIME / 1000,
+           HOST_KEY_PERIOD);
+    printf("%-8s %8s %7s | %-18s | %-11s | %-11s | %8s %7s\n", "", "", "", "per tick", "per move", "per shot", "", "");
+    printf("%-8s %8s %7s | %6s %5s %5s | %5s %5s | %5s %5s | %8s %7s\n", "strategy", "bytes", "redraw",
+           "mean", "p50", "p99", "p50", "p99", "p50", "p99", "deferred", "overrun");
+    for(s = 0; s < STRATEGIES; s++) {
+        memset(histogram, 0, sizeof(histogram));
+        bytes = deferred = overrun = played = 0;
+        for(seed = 1; seed <= SEEDS; seed++) {
+            run.seed = seed;
+            run.setup = strategies[s].setup;
+            if(Host_Isolate(Play, &run, &runResult, sizeof(runResult)) != 0) {
+                printf("%s seed %u failed\n", strategies[s].name, seed);
+                return 1;
+            }
+            for(e = 0; e < HOST_EVENTS; e++) {
+                for(b = 0; b < HOST_HISTOGRAM; b++) histogram[e][b] += runResult.host.histogram[e][b];
+                if(e != HOST_PLAY && e != HOST_OTHER) overrun += runResult.host.overrun[e];
+            }
+            // starting the game is the same for every strategy and only counts in the total
+            for(e = 0; e < HOST_EVENTS; e++) bytes += runResult.host.bytes[e];
+            deferred += runResult.screen.deferred;
+            played += runResult.host.ms;
+        }
+        if(s == 0) baseline = bytes;
+        Host_Spread(histogram[HOST_TICK_EVENT], &tick);
+        Host_Spread(histogram[HOST_MOVE], &move);
+        Host_Spread(histogram[HOST_SHOOT], &shoot);
+        printf("%-8s %8u %6.1f%% | %6.1f %5u %5u | %5u %5u | %5u %5u | %8u %7u\n", strategies[s].name, bytes,
+               100.0 * bytes / baseline, tick.count ? (double)tick.bytes / tick.count : 0.0, tick.p50, tick.p99,
+               move.p50, move.p99, shoot.p50, shoot.p99, deferred, overrun);
+    }
+    printf("played %u s in total, a tick is %d ms and anything sent between two ticks counts with the next one\n",
+           played / 1000, HOST_TICK);
+    printf("overrun counts bytes written while the %d byte transmit ring was full, outside of starting the game\n",
+           HOST_TX_BUFFER_LENGTH);
+    printf("the game over screen is sent with Screen_FlushAll() which waits for the UART, that is where they come from\n");
+    return 0;
+}
+
+/** @brief Play one seed with one strategy in a fresh process
+ */
+void Play(void * arg, void * result) {
+    run_result_t * r = result;
+    Host_Init(((host_run_t *)arg)->seed);
+    Host_Run(arg);
+    Host_GetResult(&r->host);
+    Screen_GetStats(&r->screen);
+}
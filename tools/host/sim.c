@@ -0,0 +1,93 @@
+/**
+ * @file sim.c
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Play one scripted game on the host and show what it sent
+ *
+ * @code
+ * ./sim [-s seed] [-t ms] [-k keys] [-c "scroll dch;sync on"] [-a "bytes"] [-o capture.bin] [-d]
+ * @endcode
+ *
+ * Prints the bytes sent for each kind of event. -a sends a game command
+ * once the time is up, like "bytes" or "stats". The capture holds every
+ * byte the game wrote and can be fed to tools/screen_client.c, -d prints
+ * the screen the terminal model ended up with.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "host.h"
+#include "vt.h"
+
+#define DEFAULT_SEED                1
+#define DEFAULT_TIME                60000           // ms
+#define DEFAULT_KEYS                "wd sd wwaa ss  d w s"
+
+static FILE * capture; ///< where the bytes go, 0 for nowhere
+static vt_t screen; ///< terminal the game draws on
+
+static void Sink(const uint8_t * data, uint16_t length);
+
+int main(int argc, char * argv[]) {
+    static const char * names[HOST_EVENTS] = {"play", "tick", "move", "shoot", "other"};
+    host_run_t run = {DEFAULT_SEED, DEFAULT_TIME, DEFAULT_KEYS, 0};
+    host_result_t result;
+    const char * after = 0;
+    uint8_t dump = 0, i;
+    int option;
+
+    while((option = getopt(argc, argv, "s:t:k:c:a:o:d")) != -1) {
+        switch(option) {
+            case 's': run.seed = strtoul(optarg, 0, 0); break;
+            case 't': run.ms = strtoul(optarg, 0, 0); break;
+            case 'k': run.keys = optarg; break;
+            case 'c': run.setup = optarg; break;
+            case 'a': after = optarg; break;
+            case 'o':
+                capture = fopen(optarg, "wb");
+                if(capture == 0) {
+                    perror(optarg);
+                    return 1;
+                }
+                break;
+            case 'd': dump = 1; break;
+            default:
+                fprintf(stderr, "usage: %s [-s seed] [-t ms] [-k keys] [-c commands] [-a command] [-o capture] [-d]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    VT_Init(&screen);
+    Host_Init(run.seed);
+    Host_SetSink(Sink);
+    Host_Run(&run);
+    Host_GetResult(&result);
+    if(after) Host_Command(after);
+    if(capture) fclose(capture);
+
+    printf("played %u ms%s, ring up to %u bytes, up to %u tasks", result.ms, result.over ? " until game over" : "",
+           result.ringMax, result.tasksMax);
+    if(result.taskOverflow) printf(", %u tasks did not fit", result.taskOverflow);
+    printf("\n");
+    for(i = 0; i < HOST_EVENTS; i++) {
+        if(result.bytes[i] == 0) continue;
+        printf("%-6s %8u bytes", names[i], result.bytes[i]);
+        if(result.spread[i].count) {
+            printf(" %6u events p50 %4u p99 %4u max %4u", result.spread[i].count, result.spread[i].p50,
+                   result.spread[i].p99, result.spread[i].max);
+        }
+        if(result.overrun[i]) printf(" overran the ring by %u", result.overrun[i]);
+        printf("\n");
+    }
+    if(screen.errors) printf("terminal model: %u unknown sequences, first %s\n", screen.errors, screen.firstError);
+    if(dump) VT_Dump(&screen, stdout);
+    return 0;
+}
+
+/** @brief Capture the bytes and draw them on the terminal model
+ */
+void Sink(const uint8_t * data, uint16_t length) {
+    if(capture) fwrite(data, 1, length, capture);
+    VT_Feed(&screen, data, length);
+}
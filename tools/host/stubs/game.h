@@ -0,0 +1,27 @@
+/**
+ * @file game.h
+ * @brief Host stand-in for the library game module
+ */
+
+#ifndef GAME_H_
+#define GAME_H_
+
+#include "library.h"
+#include "terminal.h"
+
+uint8_t Game_Register(char * name, char * description, void(*play)(void), void(*help)(void));
+void Game_RegisterCallback(uint8_t id, void(*callback)(int argc, char * argv[]));
+void Game_CharXY(char c, char x, char y);
+void Game_Printf(char * str, ...);
+void Game_SetColor(enum term_color color);
+void Game_ClearScreen(void);
+void Game_DrawRect(char x_min, char y_min, char x_max, char y_max);
+void Game_HideCursor(void);
+void Game_ShowCursor(void);
+void Game_Bell(void);
+void Game_GameOver(void);
+void Game_RegisterPlayer1Receiver(void(*rx)(uint8_t c));
+void Game_UnregisterPlayer1Receiver(void(*rx)(uint8_t c));
+void Game_Log(uint8_t id, char * str, ...);
+
+#endif /* GAME_H_ */
@@ -0,0 +1,14 @@
+/**
+ * @file library.h
+ * @brief Host stand-in for the embedded-software library header
+ */
+
+#ifndef LIBRARY_H_
+#define LIBRARY_H_
+
+#include <stdint.h>
+
+typedef uint32_t tint_t; ///< time in ms
+typedef uint32_t version_t;
+
+#endif /* LIBRARY_H_ */
@@ -0,0 +1,13 @@
+/**
+ * @file random_int.h
+ * @brief Host stand-in for the library random numbers, seeded by the harness
+ */
+
+#ifndef RANDOM_INT_H_
+#define RANDOM_INT_H_
+
+#include "library.h"
+
+int16_t random_int(int16_t min, int16_t max);
+
+#endif /* RANDOM_INT_H_ */
@@ -0,0 +1,9 @@
+/**
+ * @file subsystem.h
+ * @brief Host stand-in for the library subsystem module
+ */
+
+#ifndef SUBSYSTEM_H_
+#define SUBSYSTEM_H_
+
+#endif /* SUBSYSTEM_H_ */
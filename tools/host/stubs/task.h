@@ -0,0 +1,19 @@
+/**
+ * @file task.h
+ * @brief Host stand-in for the library task module
+ */
+
+#ifndef TASK_H_
+#define TASK_H_
+
+#include "library.h"
+
+typedef void(*task_t)(void);
+
+void Task_Init(void);
+void Task_Schedule(task_t fn, void * pointer, tint_t delay, tint_t period);
+void Task_Queue(task_t fn, void * pointer);
+void Task_Remove(task_t fn, void * pointer);
+void SystemTick(void);
+
+#endif /* TASK_H_ */
@@ -0,0 +1,18 @@
+/**
+ * @file terminal.h
+ * @brief Host stand-in for the library terminal module
+ */
+
+#ifndef TERMINAL_H_
+#define TERMINAL_H_
+
+#include "library.h"
+
+enum term_color {
+    ForegroundBlack = 30, ForegroundRed, ForegroundGreen, ForegroundYellow,
+    ForegroundBlue, ForegroundMagenta, ForegroundCyan, ForegroundWhite,
+    BackgroundBlack = 40, BackgroundRed, BackgroundGreen, BackgroundYellow,
+    BackgroundBlue, BackgroundMagenta, BackgroundCyan, BackgroundWhite
+};
+
+#endif /* TERMINAL_H_ */
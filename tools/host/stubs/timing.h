@@ -0,0 +1,14 @@
+/**
+ * @file timing.h
+ * @brief Host stand-in for the library timing module, time only moves when the harness says so
+ */
+
+#ifndef TIMING_H_
+#define TIMING_H_
+
+#include "library.h"
+
+tint_t TimeNow(void);
+tint_t TimeSince(tint_t t);
+
+#endif /* TIMING_H_ */
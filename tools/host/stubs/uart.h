@@ -0,0 +1,17 @@
+/**
+ * @file uart.h
+ * @brief Host stand-in for the library UART module, see host.c for the link model
+ */
+
+#ifndef UART_H_
+#define UART_H_
+
+#include "library.h"
+
+void UART_WriteByte(uint8_t channel, char c);
+void UART_Write(uint8_t channel, char * data, uint16_t length);
+void UART_printf(uint8_t channel, char * str, ...);
+uint8_t UART_IsTransmitting(uint8_t channel);
+void UART_ReconfigureBaud(uint8_t channel, uint32_t baud);
+
+#endif /* UART_H_ */
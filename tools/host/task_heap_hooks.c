@@ -0,0 +1,21 @@
+/**
+ * @file task_heap_hooks.c
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Task list hooks of host.h for runs on the heap scheduler
+ *
+ * Linked instead of task_list.c when the game is built with TASK_BACKEND
+ * set to TASK_BACKEND_HEAP, the scheduler itself is ../../task_heap.c.
+ */
+
+#include "project_settings.h"
+#include "task_heap.h"
+#include "host.h"
+
+uint8_t TaskList_Count(void) {
+    return TaskHeap_Count();
+}
+
+uint16_t TaskList_Overflow(void) {
+    return TaskHeap_Overflow();
+}
@@ -0,0 +1,82 @@
+/**
+ * @file task_list.c
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Model of the library's task list for host runs
+ *
+ * Holds TASK_MAX_LENGTH tasks like the library and walks all of them on
+ * every SystemTick(). Tasks that do not fit are counted instead of
+ * scheduled so a run shows when the list is too short.
+ */
+
+#include "project_settings.h"
+#include "task.h"
+#include "timing.h"
+#include "host.h"
+
+/// a task in the list
+typedef struct {
+    task_t fn; ///< function to run
+    void * pointer; ///< passed to the function
+    tint_t next; ///< time it runs next
+    tint_t period; ///< ms between runs, 0 to run once
+    uint8_t used; ///< entry holds a task
+} entry_t;
+
+static entry_t tasks[TASK_MAX_LENGTH];
+static uint16_t overflow; ///< tasks that did not fit
+
+void Task_Init(void) {
+    uint8_t i;
+    for(i = 0; i < TASK_MAX_LENGTH; i++) tasks[i].used = 0;
+    overflow = 0;
+}
+
+void Task_Schedule(task_t fn, void * pointer, tint_t delay, tint_t period) {
+    uint8_t i;
+    for(i = 0; i < TASK_MAX_LENGTH; i++) {
+        if(tasks[i].used) continue;
+        tasks[i].fn = fn;
+        tasks[i].pointer = pointer;
+        tasks[i].next = TimeNow() + delay;
+        tasks[i].period = period;
+        tasks[i].used = 1;
+        return;
+    }
+    overflow++;
+}
+
+void Task_Queue(task_t fn, void * pointer) {
+    Task_Schedule(fn, pointer, 0, 0);
+}
+
+void Task_Remove(task_t fn, void * pointer) {
+    uint8_t i;
+    for(i = 0; i < TASK_MAX_LENGTH; i++) {
+        if(tasks[i].used && tasks[i].fn == fn && tasks[i].pointer == pointer) tasks[i].used = 0;
+    }
+}
+
+void SystemTick(void) {
+    uint8_t i;
+    task_t fn;
+    void * pointer;
+    for(i = 0; i < TASK_MAX_LENGTH; i++) {
+        if(!tasks[i].used || (int32_t)(TimeNow() - tasks[i].next) < 0) continue;
+        fn = tasks[i].fn;
+        pointer = tasks[i].pointer;
+        if(tasks[i].period) tasks[i].next += tasks[i].period;
+        else tasks[i].used = 0;
+        ((void(*)(void *))fn)(pointer);
+    }
+}
+
+uint8_t TaskList_Count(void) {
+    uint8_t i, n = 0;
+    for(i = 0; i < TASK_MAX_LENGTH; i++) n += tasks[i].used;
+    return n;
+}
+
+uint16_t TaskList_Overflow(void) {
+    return overflow;
+}
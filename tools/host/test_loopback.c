@@ -0,0 +1,103 @@
+/**
+ * @file test_loopback.c
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Check the binary frames show the same game once the host client decoded them
+ *
+ * Each game is played once with binary output, fed through the decoder of
+ * tools/screen_client.c and drawn on the terminal model, and once with
+ * terminal sequences sent straight to the model. Once Screen_FlushAll() has
+ * sent whatever was held back both have to show the same cells.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host.h"
+#include "screen.h"
+#include "screen_decoder.h"
+#include "vt.h"
+
+#define SEEDS                       3               // games played each way
+#define RUN_TIME                    30000           // ms each game plays for at most
+#define KEYS                        "wd sd wwaa ss  d w s"
+#define REFERENCE                   "scroll redraw;backpressure block"
+#define BINARY                      "output binary"
+
+/// what a game sends back
+typedef struct {
+    vt_t screen; ///< what the terminal shows at the end
+    host_result_t host;
+} game_t;
+
+static game_t reference, game; ///< too large for the stack
+static vt_t * screen; ///< terminal the running game draws on
+static FILE * decoded; ///< decoder output, 0 when the game sends terminal sequences
+
+static void Play(void * arg, void * result);
+static void Sink(const uint8_t * data, uint16_t length);
+
+int main(void) {
+    host_run_t run = {0, RUN_TIME, KEYS, 0};
+    uint8_t seed, failed = 0;
+    uint32_t differ;
+
+    for(seed = 1; seed <= SEEDS; seed++) {
+        run.seed = seed;
+        run.setup = REFERENCE;
+        if(Host_Isolate(Play, &run, &reference, sizeof(reference)) != 0 || reference.screen.errors) {
+            printf("FAIL reference seed %u\n", seed);
+            failed = 1;
+            continue;
+        }
+        run.setup = BINARY;
+        if(Host_Isolate(Play, &run, &game, sizeof(game)) != 0) {
+            printf("FAIL binary seed %u: crashed\n", seed);
+            failed = 1;
+            continue;
+        }
+        differ = VT_Compare(&reference.screen, &game.screen, stdout);
+        if(differ || game.screen.errors || game.host.taskOverflow) {
+            printf("FAIL binary seed %u: %u cells differ, %u unknown sequences %s, %u tasks did not fit\n", seed, differ,
+                   game.screen.errors, game.screen.firstError, game.host.taskOverflow);
+            failed = 1;
+        }
+        else printf("ok   binary seed %u\n", seed);
+    }
+    return failed;
+}
+
+/** @brief Play one game in a fresh process and send everything that is still held back
+ *
+ * Binary output is collected from the decoder and drawn once the game is done.
+ */
+void Play(void * arg, void * result) {
+    game_t * g = result;
+    const host_run_t * run = arg;
+    char * text = 0;
+    size_t length = 0;
+    screen = &g->screen;
+    VT_Init(screen);
+    if(strcmp(run->setup, BINARY) == 0) {
+        decoded = open_memstream(&text, &length);
+        Decoder_Init(decoded);
+    }
+    Host_Init(run->seed);
+    Host_SetSink(Sink);
+    Host_Run(run);
+    Screen_FlushAll();
+    Host_GetResult(&g->host);
+    if(decoded) {
+        fclose(decoded);
+        VT_Feed(screen, (const uint8_t *)text, length);
+        free(text);
+    }
+}
+
+/** @brief Pass the output through the decoder or draw it on the terminal model
+ */
+void Sink(const uint8_t * data, uint16_t length) {
+    uint16_t i;
+    if(decoded) for(i = 0; i < length; i++) Decoder_Feed(data[i]);
+    else VT_Feed(screen, data, length);
+}
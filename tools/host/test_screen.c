@@ -0,0 +1,230 @@
+/**
+ * @file test_screen.c
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Check the framebuffer on its own, outside of a game
+ *
+ * Each case runs in a fresh process, draws into the framebuffer and checks
+ * what the terminal model shows once it has been flushed.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "host.h"
+#include "screen.h"
+#include "game.h"
+#include "uart.h"
+#include "vt.h"
+
+#define CASE_TIMEOUT                10              // seconds a case may take before it counts as hung
+#define LINK_TOLERANCE              10              // percent the measured link may be off by
+
+/// what a case sends back
+typedef struct {
+    uint8_t passed; ///< case passed
+    char reason[96]; ///< why it failed
+} outcome_t;
+
+static vt_t screen; ///< terminal the framebuffer draws on
+
+static void FlushAllWhileBusy(outcome_t * o);
+static void CursorAfterPlainOutput(outcome_t * o);
+static void Run(void * arg, void * result);
+static void Start(void);
+static uint32_t Overrun(void);
+static void ScrollWithinBudget(outcome_t * o);
+static void LinkTest(outcome_t * o);
+static void Fill(uint8_t seed, uint8_t y_min, uint8_t y_max, uint8_t shift);
+static uint16_t Check(uint8_t seed, uint8_t y_min, uint8_t y_max, uint8_t shift);
+static uint8_t Pattern(uint8_t seed, uint8_t x, uint8_t y);
+static void Sink(const uint8_t * data, uint16_t length);
+
+/// every case and its name
+static const struct {
+    const char * name;
+    void (*fn)(outcome_t * o);
+} cases[] = {
+    {"flush all while the UART is busy", FlushAllWhileBusy},
+    {"cursor after plain output", CursorAfterPlainOutput},
+    {"scroll dch within the budget", ScrollWithinBudget},
+    {"scroll margins within the budget", ScrollWithinBudget},
+    {"link test measures the link", LinkTest},
+};
+#define CASES                       (sizeof(cases) / sizeof(cases[0]))
+
+int main(void) {
+    outcome_t outcome;
+    uint8_t i, failed = 0;
+    for(i = 0; i < CASES; i++) {
+        if(Host_Isolate(Run, (void *)&cases[i], &outcome, sizeof(outcome)) != 0) {
+            strcpy(outcome.reason, "crashed or hung");
+            outcome.passed = 0;
+        }
+        if(outcome.passed) printf("ok   %s\n", cases[i].name);
+        else {
+            printf("FAIL %s: %s\n", cases[i].name, outcome.reason);
+            failed = 1;
+        }
+    }
+    return failed;
+}
+
+/** @brief Screen_FlushAll() sends a full screen even when the UART already has a full buffer to send
+ */
+void FlushAllWhileBusy(outcome_t * o) {
+    char busy[HOST_TX_BUFFER_LENGTH];
+    screen_stats_t stats;
+    uint16_t differ;
+    Start();
+    Fill(1, 0, SCREEN_HEIGHT - 1, 0);
+    memset(busy, ' ', sizeof(busy));
+    UART_Write(0, busy, sizeof(busy));
+    Host_Advance(2); // the budget refills while the UART is still sending
+    Screen_FlushAll();
+    Screen_GetStats(&stats);
+    differ = Check(1, 0, SCREEN_HEIGHT - 1, 0);
+    if(differ) snprintf(o->reason, sizeof(o->reason), "%u cells not shown, %u deferred", differ, stats.deferred);
+    else if(TaskList_Count()) snprintf(o->reason, sizeof(o->reason), "a retry is still scheduled");
+    else o->passed = 1;
+}
+
+/** @brief The flush after text was printed around the framebuffer does not rely on the old cursor or color
+ */
+void CursorAfterPlainOutput(outcome_t * o) {
+    uint16_t differ;
+    Start();
+    Fill(1, 0, SCREEN_HEIGHT - 1, 0);
+    Screen_FlushAll();
+    Game_SetColor(ForegroundGreen);
+    Game_CharXY('\r', 0, SCREEN_HEIGHT);
+    Screen_Invalidate();
+    Fill(2, 0, SCREEN_HEIGHT - 1, 0);
+    Screen_FlushAll();
+    differ = Check(2, 0, SCREEN_HEIGHT - 1, 0);
+    if(differ) snprintf(o->reason, sizeof(o->reason), "%u cells not shown", differ);
+    else o->passed = 1;
+}
+
+/** @brief Scrolling the terminal never sends more than the budget has room for
+ *
+ * A flush of the top rows uses up the budget, the scroll of the rows below
+ * that follows has to leave them for the redraw.
+ */
+void ScrollWithinBudget(outcome_t * o) {
+    uint16_t differ;
+    uint32_t before;
+    Start();
+    Screen_SetScrollMode(strstr(o->reason, "margins") ? SCREEN_SCROLL_MARGINS : SCREEN_SCROLL_DCH);
+    Fill(1, 0, SCREEN_HEIGHT - 1, 0);
+    Screen_FlushAll();
+    Host_Advance(100);
+    Fill(2, 0, 4, 0);
+    Screen_Flush();
+    before = Overrun();
+    Screen_ScrollLeft(0, 5, SCREEN_WIDTH - 1, SCREEN_HEIGHT - 1);
+    if(Overrun() != before) {
+        snprintf(o->reason, sizeof(o->reason), "overran the transmit buffer by %u bytes", Overrun() - before);
+        return;
+    }
+    Fill(1, 5, SCREEN_HEIGHT - 1, 1);
+    Screen_FlushAll();
+    differ = Check(2, 0, 4, 0) + Check(1, 5, SCREEN_HEIGHT - 1, 1);
+    if(differ) snprintf(o->reason, sizeof(o->reason), "%u cells not shown", differ);
+    else o->passed = 1;
+}
+
+/** @brief The link test finishes on the host UART and measures the rate the ring drains at
+ */
+void LinkTest(outcome_t * o) {
+    screen_link_t link;
+    uint32_t low = HOST_LINK_RATE * (100 - LINK_TOLERANCE) / 100, high = HOST_LINK_RATE * (100 + LINK_TOLERANCE) / 100;
+    Start();
+    Screen_LinkTest(&link);
+    if(link.bytesPerSecond < low || link.bytesPerSecond > high || link.drainRate < low || link.drainRate > high) {
+        snprintf(o->reason, sizeof(o->reason), "measured %u bytes/s draining at %u, the link runs at %d",
+                 link.bytesPerSecond, link.drainRate, HOST_LINK_RATE);
+    }
+    else if(link.stall == 0) snprintf(o->reason, sizeof(o->reason), "never waited for the UART");
+    else if(screen.errors) snprintf(o->reason, sizeof(o->reason), "unknown sequence %s", screen.firstError);
+    else o->passed = 1;
+}
+
+/** @brief Run a case in a fresh process, the name of the case is passed in the reason
+ */
+void Run(void * arg, void * result) {
+    outcome_t * o = result;
+    alarm(CASE_TIMEOUT); // a case that never returns ends the process instead of the test
+    memset(o, 0, sizeof(*o));
+    strncpy(o->reason, cases[(typeof(&cases[0]))arg - cases].name, sizeof(o->reason) - 1);
+    ((typeof(&cases[0]))arg)->fn(o);
+}
+
+/** @brief Start from a blank terminal and framebuffer
+ */
+void Start(void) {
+    VT_Init(&screen);
+    Host_Init(1);
+    Host_SetSink(Sink);
+    Screen_Init();
+}
+
+/** @brief Bytes written so far while the transmit buffer was full
+ */
+uint32_t Overrun(void) {
+    static host_result_t result; // too large for the stack
+    uint8_t i;
+    uint32_t bytes = 0;
+    Host_GetResult(&result);
+    for(i = 0; i < HOST_EVENTS; i++) bytes += result.overrun[i];
+    return bytes;
+}
+
+/** @brief Pick the cell of a pattern, blank below 10 and a letter in one of seven colors above
+ */
+uint8_t Pattern(uint8_t seed, uint8_t x, uint8_t y) {
+    // about a third of the cells are blanks so erasing runs gets used as well
+    return (x * 7 + y * 13 + seed * 5) % 29;
+}
+
+/** @brief Draw a pattern over rows of the framebuffer, cells differ in glyph and color
+ *
+ * @param seed pattern to draw
+ * @param y_min first row
+ * @param y_max last row
+ * @param shift columns the pattern is moved to the left
+ */
+void Fill(uint8_t seed, uint8_t y_min, uint8_t y_max, uint8_t shift) {
+    uint8_t x, y, n;
+    for(y = y_min; y <= y_max; y++) {
+        for(x = 0; x < SCREEN_WIDTH; x++) {
+            n = Pattern(seed, x + shift, y);
+            Screen_SetColor((enum term_color)(ForegroundBlack + 1 + n % 7));
+            Screen_CharXY(n < 10 ? ' ' : 'A' + n - 10, x, y);
+        }
+    }
+    Screen_SetColor(ForegroundWhite);
+}
+
+/** @brief Count the cells the terminal does not show the way Fill drew them
+ */
+uint16_t Check(uint8_t seed, uint8_t y_min, uint8_t y_max, uint8_t shift) {
+    uint8_t x, y, n;
+    uint16_t differ = 0;
+    vt_cell_t * cell;
+    for(y = y_min; y <= y_max; y++) {
+        for(x = 0; x < SCREEN_WIDTH; x++) {
+            n = Pattern(seed, x + shift, y);
+            cell = &screen.cells[y][x];
+            if(n < 10) differ += cell->glyph != ' ';
+            else differ += cell->glyph != 'A' + n - 10 || cell->fg != ForegroundBlack + 1 + n % 7;
+        }
+    }
+    return differ + (screen.errors != 0);
+}
+
+/** @brief Draw the output on the terminal model
+ */
+void Sink(const uint8_t * data, uint16_t length) {
+    VT_Feed(&screen, data, length);
+}
@@ -0,0 +1,102 @@
+/**
+ * @file test_strategies.c
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Check every way of sending the screen ends up showing the same game
+ *
+ * Each strategy plays the same scripted games as a plain redraw that is
+ * allowed to wait for the UART. Once whatever was held back has been sent
+ * with Screen_FlushAll() the terminal model has to show the same cells,
+ * and it must never have been sent a sequence it does not know.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "host.h"
+#include "screen.h"
+#include "vt.h"
+
+#define SEEDS                       3               // games played by each strategy
+#define RUN_TIME                    30000           // ms each game plays for at most
+#define KEYS                        "wd sd wwaa ss  d w s"
+#define REFERENCE                   "scroll redraw;backpressure block"
+
+/// a way of sending the screen and the commands that select it
+typedef struct {
+    const char * name;
+    const char * setup;
+} strategy_t;
+
+/// what a game sends back
+typedef struct {
+    vt_t screen; ///< what the terminal shows at the end
+    host_result_t host;
+} game_t;
+
+static const strategy_t strategies[] = {
+    {"redraw", "scroll redraw"},
+    {"dch", "scroll dch"},
+    {"margins", "scroll margins"},
+    {"sync", "sync on"},
+    {"dch drop", "scroll dch;backpressure drop"},
+    {"margins sync", "scroll margins;sync on"},
+};
+#define STRATEGIES                  (sizeof(strategies) / sizeof(strategies[0]))
+
+static game_t reference, game; ///< too large for the stack
+static vt_t * screen; ///< terminal the running game draws on
+
+static void Play(void * arg, void * result);
+static void Sink(const uint8_t * data, uint16_t length);
+
+int main(void) {
+    host_run_t run = {0, RUN_TIME, KEYS, REFERENCE};
+    uint8_t s, seed, failed = 0;
+    uint32_t differ;
+
+    for(seed = 1; seed <= SEEDS; seed++) {
+        run.seed = seed;
+        run.setup = REFERENCE;
+        if(Host_Isolate(Play, &run, &reference, sizeof(reference)) != 0 || reference.screen.errors) {
+            printf("FAIL reference seed %u\n", seed);
+            failed = 1;
+            continue;
+        }
+        for(s = 0; s < STRATEGIES; s++) {
+            run.setup = strategies[s].setup;
+            if(Host_Isolate(Play, &run, &game, sizeof(game)) != 0) {
+                printf("FAIL %s seed %u: crashed\n", strategies[s].name, seed);
+                failed = 1;
+                continue;
+            }
+            differ = VT_Compare(&reference.screen, &game.screen, stdout);
+            if(differ || game.screen.errors || game.host.taskOverflow) {
+                printf("FAIL %s seed %u: %u cells differ, %u unknown sequences %s, %u tasks did not fit\n",
+                       strategies[s].name, seed, differ, game.screen.errors, game.screen.firstError,
+                       game.host.taskOverflow);
+                failed = 1;
+            }
+            else printf("ok   %s seed %u\n", strategies[s].name, seed);
+        }
+    }
+    return failed;
+}
+
+/** @brief Play one game in a fresh process and send everything that is still held back
+ */
+void Play(void * arg, void * result) {
+    game_t * g = result;
+    screen = &g->screen;
+    VT_Init(screen);
+    Host_Init(((host_run_t *)arg)->seed);
+    Host_SetSink(Sink);
+    Host_Run(arg);
+    Screen_FlushAll();
+    Host_GetResult(&g->host);
+}
+
+/** @brief Draw the output on the terminal model
+ */
+void Sink(const uint8_t * data, uint16_t length) {
+    VT_Feed(screen, data, length);
+}
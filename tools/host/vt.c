@@ -0,0 +1,252 @@
+/**
+ * @file vt.c
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Model of the terminal the game draws on
+ */
+
+#include <string.h>
+#include "vt.h"
+
+// Parser states
+#define STATE_TEXT                  0               // printing
+#define STATE_ESCAPE                1               // escape seen
+#define STATE_CSI                   2               // inside a control sequence
+
+#define DEFAULT_FG                  37
+#define DEFAULT_BG                  40
+#define COMPARE_LOG                 10              // differences described by VT_Compare
+
+static void Print(vt_t * vt, uint8_t c);
+static void Execute(vt_t * vt, uint8_t command);
+static void Erase(vt_t * vt, uint8_t y, uint8_t from, uint8_t to);
+static void Shift(vt_t * vt, uint8_t y, uint8_t from, uint8_t to, uint8_t n, uint8_t left);
+static uint16_t Parameter(const vt_t * vt, uint8_t i, uint16_t otherwise);
+static void Error(vt_t * vt, const char * what, uint8_t command);
+
+void VT_Init(vt_t * vt) {
+    memset(vt, 0, sizeof(*vt));
+    vt->fg = DEFAULT_FG;
+    vt->bg = DEFAULT_BG;
+    vt->bottom = VT_HEIGHT - 1;
+    vt->right = VT_WIDTH - 1;
+    Erase(vt, 0, 0, VT_WIDTH - 1);
+    for(vt->y = 1; vt->y < VT_HEIGHT; vt->y++) Erase(vt, vt->y, 0, VT_WIDTH - 1);
+    vt->y = 0;
+}
+
+void VT_Feed(vt_t * vt, const uint8_t * data, uint32_t length) {
+    uint8_t c;
+    for(; length > 0; length--, data++) {
+        c = *data;
+        switch(vt->state) {
+            case STATE_TEXT:
+                if(c == 0x1B) vt->state = STATE_ESCAPE;
+                else if(c == '\r') vt->x = 0;
+                else if(c == '\n') { if(vt->y < VT_HEIGHT - 1) vt->y++; }
+                else if(c == '\b') { if(vt->x > 0) vt->x--; }
+                else if(c == '\a') ;
+                else if(c < ' ') Error(vt, "control", c);
+                else Print(vt, c);
+                break;
+            case STATE_ESCAPE:
+                if(c == '[') {
+                    vt->state = STATE_CSI;
+                    vt->private = 0;
+                    vt->intermediate = 0;
+                    vt->count = 0;
+                    memset(vt->parameters, 0, sizeof(vt->parameters));
+                }
+                else {
+                    Error(vt, "escape", c);
+                    vt->state = STATE_TEXT;
+                }
+                break;
+            case STATE_CSI:
+                if(c == '?' && vt->count == 0) vt->private = 1;
+                else if(c >= '0' && c <= '9') {
+                    if(vt->count == 0) vt->count = 1;
+                    if(vt->count <= VT_PARAMETERS) {
+                        vt->parameters[vt->count - 1] = vt->parameters[vt->count - 1] * 10 + c - '0';
+                    }
+                }
+                else if(c == ';') vt->count = (vt->count ? vt->count : 1) + 1;
+                else if(c == ' ') vt->intermediate = 1;
+                else if(c >= '@' && c <= '~') {
+                    vt->state = STATE_TEXT;
+                    Execute(vt, c);
+                }
+                else {
+                    Error(vt, "sequence", c);
+                    vt->state = STATE_TEXT;
+                }
+                break;
+        }
+    }
+}
+
+uint32_t VT_Compare(const vt_t * a, const vt_t * b, FILE * log) {
+    uint8_t x, y;
+    uint32_t differ = 0;
+    const vt_cell_t * p, * q;
+    for(y = 0; y < VT_HEIGHT; y++) {
+        for(x = 0; x < VT_WIDTH; x++) {
+            p = &a->cells[y][x];
+            q = &b->cells[y][x];
+            if(p->glyph == q->glyph && (p->glyph == ' ' || (p->fg == q->fg && p->bg == q->bg))) continue;
+            if(log && differ < COMPARE_LOG) {
+                fprintf(log, "cell %u,%u: '%c' %u;%u against '%c' %u;%u\n", x, y, p->glyph, p->fg, p->bg,
+                        q->glyph, q->fg, q->bg);
+            }
+            differ++;
+        }
+    }
+    return differ;
+}
+
+void VT_Dump(const vt_t * vt, FILE * out) {
+    uint8_t x, y, end;
+    for(y = 0; y < VT_HEIGHT; y++) {
+        for(end = VT_WIDTH; end > 0 && vt->cells[y][end - 1].glyph == ' '; end--);
+        for(x = 0; x < end; x++) fputc(vt->cells[y][x].glyph, out);
+        fputc('\n', out);
+    }
+}
+
+/** @brief Put a character at the cursor and move on, stopping at the right edge
+ */
+void Print(vt_t * vt, uint8_t c) {
+    vt_cell_t * cell = &vt->cells[vt->y][vt->x];
+    cell->glyph = c;
+    cell->fg = vt->fg;
+    cell->bg = vt->bg;
+    if(vt->x < VT_WIDTH - 1) vt->x++;
+}
+
+/** @brief Carry out a control sequence once its final byte is in
+ */
+void Execute(vt_t * vt, uint8_t command) {
+    uint16_t n = Parameter(vt, 0, 1), i;
+    uint8_t y, right;
+    if(vt->private) {
+        if(command != 'h' && command != 'l') Error(vt, "private", command);
+        else if(vt->parameters[0] == 69) {
+            vt->marginMode = command == 'h';
+            vt->left = 0;
+            vt->right = VT_WIDTH - 1;
+        }
+        else if(vt->parameters[0] != 25 && vt->parameters[0] != 2026) Error(vt, "mode", command);
+        return;
+    }
+    if(vt->intermediate) { // scroll left inside the margins
+        if(command != '@') {
+            Error(vt, "intermediate", command);
+            return;
+        }
+        for(y = vt->top; y <= vt->bottom; y++) Shift(vt, y, vt->left, vt->right, n, 1);
+        return;
+    }
+    switch(command) {
+        case 'H':
+            vt->y = Parameter(vt, 0, 1) - 1;
+            vt->x = Parameter(vt, 1, 1) - 1;
+            if(vt->y >= VT_HEIGHT) vt->y = VT_HEIGHT - 1;
+            if(vt->x >= VT_WIDTH) vt->x = VT_WIDTH - 1;
+            break;
+        case 'A': vt->y = n > vt->y ? 0 : vt->y - n; break;
+        case 'B': vt->y = vt->y + n >= VT_HEIGHT ? VT_HEIGHT - 1 : vt->y + n; break;
+        case 'C': vt->x = vt->x + n >= VT_WIDTH ? VT_WIDTH - 1 : vt->x + n; break;
+        case 'D': vt->x = n > vt->x ? 0 : vt->x - n; break;
+        case 'G': vt->x = n > VT_WIDTH ? VT_WIDTH - 1 : n - 1; break;
+        case 'm':
+            if(vt->count == 0) vt->count = 1;
+            for(i = 0; i < vt->count && i < VT_PARAMETERS; i++) {
+                n = vt->parameters[i];
+                if(n == 0) { vt->fg = DEFAULT_FG; vt->bg = DEFAULT_BG; }
+                else if(n >= 30 && n <= 37) vt->fg = n;
+                else if(n >= 40 && n <= 47) vt->bg = n;
+                else if(n == 39) vt->fg = DEFAULT_FG;
+                else if(n == 49) vt->bg = DEFAULT_BG;
+                else Error(vt, "color", command);
+            }
+            break;
+        case 'X':
+            Erase(vt, vt->y, vt->x, vt->x + n > VT_WIDTH ? VT_WIDTH - 1 : vt->x + n - 1);
+            break;
+        case 'K':
+            if(vt->parameters[0] == 0) Erase(vt, vt->y, vt->x, VT_WIDTH - 1);
+            else if(vt->parameters[0] == 1) Erase(vt, vt->y, 0, vt->x);
+            else Erase(vt, vt->y, 0, VT_WIDTH - 1);
+            break;
+        case 'J':
+            if(vt->parameters[0] != 2) Error(vt, "erase", command);
+            else for(y = 0; y < VT_HEIGHT; y++) Erase(vt, y, 0, VT_WIDTH - 1);
+            break;
+        case 'r': // scroll region, homes the cursor
+            vt->top = Parameter(vt, 0, 1) - 1;
+            vt->bottom = Parameter(vt, 1, VT_HEIGHT) - 1;
+            if(vt->bottom >= VT_HEIGHT) vt->bottom = VT_HEIGHT - 1;
+            vt->x = 0;
+            vt->y = 0;
+            break;
+        case 's': // left/right margins, homes the cursor
+            if(!vt->marginMode) {
+                Error(vt, "margins", command);
+                break;
+            }
+            vt->left = Parameter(vt, 0, 1) - 1;
+            vt->right = Parameter(vt, 1, VT_WIDTH) - 1;
+            if(vt->right >= VT_WIDTH) vt->right = VT_WIDTH - 1;
+            vt->x = 0;
+            vt->y = 0;
+            break;
+        case 'P':
+        case '@':
+            // inside the margins only the margins move, otherwise up to the edge of the screen
+            right = vt->marginMode && vt->x >= vt->left && vt->x <= vt->right ? vt->right : VT_WIDTH - 1;
+            Shift(vt, vt->y, vt->x, right, n, command == 'P');
+            break;
+        default:
+            Error(vt, "command", command);
+            break;
+    }
+}
+
+/** @brief Blank cells of a row in the current background
+ */
+void Erase(vt_t * vt, uint8_t y, uint8_t from, uint8_t to) {
+    for(; from <= to && from < VT_WIDTH; from++) {
+        vt->cells[y][from].glyph = ' ';
+        vt->cells[y][from].fg = vt->fg;
+        vt->cells[y][from].bg = vt->bg;
+    }
+}
+
+/** @brief Move part of a row left or right, blanking what is left behind
+ */
+void Shift(vt_t * vt, uint8_t y, uint8_t from, uint8_t to, uint8_t n, uint8_t left) {
+    int x;
+    if(to < from) return;
+    if(n > to - from + 1) n = to - from + 1;
+    if(left) {
+        for(x = from; x + n <= to; x++) vt->cells[y][x] = vt->cells[y][x + n];
+        Erase(vt, y, to - n + 1, to);
+    }
+    else {
+        for(x = to; x - n >= from; x--) vt->cells[y][x] = vt->cells[y][x - n];
+        Erase(vt, y, from, from + n - 1);
+    }
+}
+
+/** @brief Read a parameter of the sequence, 0 or left out takes the default
+ */
+uint16_t Parameter(const vt_t * vt, uint8_t i, uint16_t otherwise) {
+    if(i >= vt->count || vt->parameters[i] == 0) return otherwise;
+    return vt->parameters[i];
+}
+
+/** @brief Count a sequence the model does not know and remember the first one
+ */
+void Error(vt_t * vt, const char * what, uint8_t command) {
+    if(vt->errors++ == 0) snprintf(vt->firstError, sizeof(vt->firstError), "%s 0x%02X", what, command);
+}
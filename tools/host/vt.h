@@ -0,0 +1,84 @@
+/**
+ * @file vt.h
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Model of the terminal the game draws on
+ *
+ * Understands the sequences the game and the library send: cursor moves,
+ * colors, erase character and line, clearing the screen, delete and insert
+ * character, left/right margins and scroll left. Printing does not wrap at
+ * the right edge. Anything else is counted as an error so a test notices
+ * output a real terminal might show differently.
+ */
+
+#ifndef VT_H_
+#define VT_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define VT_WIDTH                    80              // columns of the terminal
+#define VT_HEIGHT                   30              // rows of the terminal
+#define VT_PARAMETERS               4               // parameters kept for each sequence
+
+/// a cell of the terminal
+typedef struct {
+    uint8_t glyph; ///< character shown
+    uint8_t fg; ///< foreground color code, 30 to 37
+    uint8_t bg; ///< background color code, 40 to 47
+} vt_cell_t;
+
+/// terminal state
+typedef struct {
+    vt_cell_t cells[VT_HEIGHT][VT_WIDTH]; ///< what the terminal shows
+    uint8_t x; ///< cursor column
+    uint8_t y; ///< cursor row
+    uint8_t fg; ///< foreground printed with
+    uint8_t bg; ///< background printed with
+    uint8_t top; ///< first row of the scroll region
+    uint8_t bottom; ///< last row of the scroll region
+    uint8_t left; ///< first column of the margins
+    uint8_t right; ///< last column of the margins
+    uint8_t marginMode; ///< left/right margins are allowed
+    uint8_t state; ///< what the next byte is part of
+    uint8_t private; ///< sequence started with '?'
+    uint8_t intermediate; ///< sequence has a space before the final byte
+    uint8_t count; ///< parameters seen
+    uint16_t parameters[VT_PARAMETERS]; ///< parameters of the sequence
+    uint32_t errors; ///< sequences the model does not know
+    char firstError[32]; ///< the first of them
+} vt_t;
+
+/** Start with a blank screen and the cursor at the top left
+ *
+ * @param vt terminal
+ */
+void VT_Init(vt_t * vt);
+
+/** Feed bytes sent to the terminal, sequences may be split between calls
+ *
+ * @param vt terminal
+ * @param data bytes to feed
+ * @param length number of bytes
+ */
+void VT_Feed(vt_t * vt, const uint8_t * data, uint32_t length);
+
+/** Count the cells that look different on two terminals
+ *
+ * Blanks are the same whatever their color.
+ *
+ * @param a first terminal
+ * @param b second terminal
+ * @param log where to describe the first few differences, 0 for nowhere
+ * @return number of cells that differ
+ */
+uint32_t VT_Compare(const vt_t * a, const vt_t * b, FILE * log);
+
+/** Print what the terminal shows
+ *
+ * @param vt terminal
+ * @param out where to print it
+ */
+void VT_Dump(const vt_t * vt, FILE * out);
+
+#endif /* VT_H_ */
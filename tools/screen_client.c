@@ -0,0 +1,118 @@
+/**
+ * @file screen_client.c
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Host client that draws the binary frames sent by the game
+ *
+ * Sits between the serial port and the terminal when the game runs with
+ * "$game fly1 output binary". Binary frames (see screen_protocol.h) are
+ * turned back into terminal sequences on the host, everything else is
+ * passed on as is. Keys typed in the terminal are sent to the serial port.
+ *
+ * Build on Linux with:
+ * @code
+ * gcc -O2 -I.. -o screen_client screen_client.c screen_decoder.c
+ * @endcode
+ *
+ * Run with the serial port to talk to the game, Ctrl+] quits:
+ * @code
+ * ./screen_client /dev/ttyACM0
+ * @endcode
+ *
+ * Without a serial port it reads a recorded stream from stdin instead:
+ * @code
+ * ./screen_client < capture.bin
+ * @endcode
+ */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#include "screen_decoder.h"
+
+#define BAUD                        B460800         // same as GAME_UART_BAUD
+#define QUIT_KEY                    0x1D            // Ctrl+]
+
+static struct termios savedTerminal; ///< stdin settings to restore at exit
+
+static void RestoreTerminal(void);
+static int OpenSerial(const char * path);
+
+int main(int argc, char * argv[]) {
+    uint8_t data[256];
+    ssize_t n, i;
+    struct pollfd fds[2];
+    struct termios raw;
+    int serial;
+
+    Decoder_Init(stdout);
+    if(argc < 2) { // decode a recording
+        while((n = read(STDIN_FILENO, data, sizeof(data))) > 0) {
+            for(i = 0; i < n; i++) Decoder_Feed(data[i]);
+            fflush(stdout);
+        }
+        return 0;
+    }
+
+    serial = OpenSerial(argv[1]);
+    if(serial < 0) {
+        perror(argv[1]);
+        return 1;
+    }
+    // keys go to the game one at a time without echo
+    if(tcgetattr(STDIN_FILENO, &savedTerminal) == 0) {
+        raw = savedTerminal;
+        cfmakeraw(&raw);
+        tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+        atexit(RestoreTerminal);
+    }
+
+    fds[0].fd = STDIN_FILENO;
+    fds[0].events = POLLIN;
+    fds[1].fd = serial;
+    fds[1].events = POLLIN;
+    while(poll(fds, 2, -1) >= 0) {
+        if(fds[0].revents & POLLIN) {
+            n = read(STDIN_FILENO, data, sizeof(data));
+            if(n <= 0) break;
+            for(i = 0; i < n; i++) if(data[i] == QUIT_KEY) return 0;
+            if(write(serial, data, n) != n) break;
+        }
+        if(fds[1].revents & POLLIN) {
+            n = read(serial, data, sizeof(data));
+            if(n <= 0) break;
+            for(i = 0; i < n; i++) Decoder_Feed(data[i]);
+            fflush(stdout);
+        }
+        if((fds[0].revents | fds[1].revents) & (POLLHUP | POLLERR)) break;
+    }
+    return 0;
+}
+
+/** @brief Put stdin back the way it was
+ */
+void RestoreTerminal(void) {
+    tcsetattr(STDIN_FILENO, TCSANOW, &savedTerminal);
+}
+
+/** @brief Open the serial port connected to the game
+ *
+ * @param path device of the serial port
+ * @return file descriptor or -1 on error
+ */
+int OpenSerial(const char * path) {
+    struct termios tty;
+    int fd = open(path, O_RDWR | O_NOCTTY);
+    if(fd < 0) return -1;
+    if(tcgetattr(fd, &tty) == 0) {
+        cfmakeraw(&tty);
+        cfsetispeed(&tty, BAUD);
+        cfsetospeed(&tty, BAUD);
+        tcsetattr(fd, TCSANOW, &tty);
+    }
+    return fd;
+}
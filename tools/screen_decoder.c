@@ -0,0 +1,187 @@
+/**
+ * @file screen_decoder.c
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Turns the binary frames sent by the game back into terminal sequences
+ *
+ * A state machine fed one byte at a time, so frames can be split anywhere
+ * between reads. Plain output between frames can move the cursor and change
+ * colors, so the first cell drawn after it always sends both.
+ */
+
+#include <string.h>
+#include "screen_decoder.h"
+#include "screen_protocol.h"
+
+#define NO_COLOR                    -1              // terminal color is not known
+
+// Decoder states
+#define STATE_TEXT                  0               // passing plain output on
+#define STATE_ESCAPE                1               // escape seen, might start a frame
+#define STATE_ROW_GROUPS            2               // reading the groups of rows
+#define STATE_ROWS                  3               // reading the rows of a group
+#define STATE_GROUPS                4               // reading the groups of a row
+#define STATE_COLUMNS               5               // reading the columns of a group
+#define STATE_GLYPH                 6               // reading the glyph of a cell
+#define STATE_COLOR                 7               // reading the color of a cell
+
+/// decoder state between reads
+static struct {
+    uint8_t state; ///< what the next byte is
+    uint8_t rowGroups; ///< groups of rows with changes
+    int8_t rowGroup; ///< group of rows being read
+    uint32_t rows; ///< rows in the frame
+    int8_t row; ///< row being read
+    uint8_t groups; ///< groups with changes in the row
+    int8_t group; ///< group being read
+    uint8_t columns[SCREEN_PROTOCOL_COLUMN_GROUPS]; ///< columns with changes by group
+    int8_t column; ///< column being read
+    uint8_t glyph; ///< glyph of the cell being read
+    uint8_t color; ///< color of the last cell
+} decoder;
+
+static FILE * out; ///< where the terminal sequences go
+static int cursorX = -1; ///< column of the local cursor, -1 if not known
+static int cursorY = -1; ///< row of the local cursor
+static int shownColor = NO_COLOR; ///< color the local terminal is printing with
+
+static void NextRowGroup(void);
+static void NextRow(void);
+static void NextGroup(void);
+static void NextColumn(void);
+static void DrawCell(void);
+
+void Decoder_Init(FILE * stream) {
+    memset(&decoder, 0, sizeof(decoder));
+    decoder.state = STATE_TEXT;
+    out = stream;
+    cursorX = -1;
+    cursorY = -1;
+    shownColor = NO_COLOR;
+}
+
+void Decoder_Feed(uint8_t b) {
+    switch(decoder.state) {
+        case STATE_TEXT:
+            if(b == SCREEN_PROTOCOL_START_0) decoder.state = STATE_ESCAPE;
+            else {
+                fputc(b, out);
+                // plain output can move the cursor and change colors
+                cursorX = -1;
+                shownColor = NO_COLOR;
+            }
+            break;
+        case STATE_ESCAPE:
+            if(b == SCREEN_PROTOCOL_START_1) {
+                decoder.rows = 0;
+                decoder.row = -1;
+                decoder.color = SCREEN_PROTOCOL_DEFAULT_COLOR;
+                decoder.state = STATE_ROW_GROUPS;
+            }
+            else { // just an escape sequence
+                fputc(SCREEN_PROTOCOL_START_0, out);
+                decoder.state = STATE_TEXT;
+                Decoder_Feed(b);
+            }
+            break;
+        case STATE_ROW_GROUPS:
+            decoder.rowGroups = b;
+            decoder.rowGroup = -1;
+            NextRowGroup();
+            break;
+        case STATE_ROWS:
+            decoder.rows |= (uint32_t)b << (SCREEN_PROTOCOL_GROUP_WIDTH * decoder.rowGroup);
+            NextRowGroup();
+            break;
+        case STATE_GROUPS:
+            decoder.groups = b;
+            decoder.group = -1;
+            NextGroup();
+            break;
+        case STATE_COLUMNS:
+            decoder.columns[decoder.group] = b;
+            NextGroup();
+            break;
+        case STATE_GLYPH:
+            decoder.glyph = b & ~SCREEN_PROTOCOL_COLOR_FLAG;
+            if(b & SCREEN_PROTOCOL_COLOR_FLAG) decoder.state = STATE_COLOR;
+            else {
+                DrawCell();
+                NextColumn();
+            }
+            break;
+        case STATE_COLOR:
+            decoder.color = b;
+            DrawCell();
+            NextColumn();
+            break;
+    }
+}
+
+/** @brief Move on to the next group of rows or to the first row
+ */
+void NextRowGroup(void) {
+    while(++decoder.rowGroup < SCREEN_PROTOCOL_ROW_GROUPS) {
+        if(decoder.rowGroups & (1 << decoder.rowGroup)) {
+            decoder.state = STATE_ROWS;
+            return;
+        }
+    }
+    NextRow();
+}
+
+/** @brief Move on to the next row in the frame or end the frame
+ */
+void NextRow(void) {
+    uint8_t group;
+    while(++decoder.row < SCREEN_PROTOCOL_ROWS) {
+        if(decoder.rows & ((uint32_t)1 << decoder.row)) break;
+    }
+    if(decoder.row >= SCREEN_PROTOCOL_ROWS) {
+        decoder.state = STATE_TEXT;
+        return;
+    }
+    for(group = 0; group < SCREEN_PROTOCOL_COLUMN_GROUPS; group++) decoder.columns[group] = 0;
+    decoder.state = STATE_GROUPS;
+}
+
+/** @brief Move on to the next group of the row or to its cells
+ */
+void NextGroup(void) {
+    while(++decoder.group < SCREEN_PROTOCOL_COLUMN_GROUPS) {
+        if(decoder.groups & (1 << decoder.group)) {
+            decoder.state = STATE_COLUMNS;
+            return;
+        }
+    }
+    decoder.column = -1;
+    NextColumn();
+}
+
+/** @brief Move on to the next cell of the row or to the next row
+ */
+void NextColumn(void) {
+    while(++decoder.column < SCREEN_PROTOCOL_COLUMNS) {
+        if(decoder.columns[decoder.column / SCREEN_PROTOCOL_GROUP_WIDTH] &
+           (1 << (decoder.column % SCREEN_PROTOCOL_GROUP_WIDTH))) {
+            decoder.state = STATE_GLYPH;
+            return;
+        }
+    }
+    NextRow();
+}
+
+/** @brief Draw the cell that was just read on the local terminal
+ */
+void DrawCell(void) {
+    if(cursorY != decoder.row || cursorX != decoder.column) {
+        fprintf(out, "\x1B[%d;%dH", decoder.row + 1, decoder.column + 1);
+    }
+    if(shownColor != decoder.color) {
+        fprintf(out, "\x1B[%d;%dm", SCREEN_PROTOCOL_FG(decoder.color), SCREEN_PROTOCOL_BG(decoder.color));
+        shownColor = decoder.color;
+    }
+    fputc(decoder.glyph, out);
+    cursorX = decoder.column + 1;
+    cursorY = decoder.row;
+}
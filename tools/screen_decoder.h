@@ -0,0 +1,30 @@
+/**
+ * @file screen_decoder.h
+ * @author Stephen Glass
+ * @date Oct 16 2026
+ * @brief Turns the binary frames sent by the game back into terminal sequences
+ *
+ * Used by screen_client.c and by the host tests. Binary frames (see
+ * screen_protocol.h) are drawn with cursor positions and colors, everything
+ * else is passed on as is.
+ */
+
+#ifndef SCREEN_DECODER_H_
+#define SCREEN_DECODER_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+/** Start outside of a frame with nothing known about the terminal
+ *
+ * @param out where the terminal sequences go
+ */
+void Decoder_Init(FILE * out);
+
+/** Feed one byte from the game, frames may be split over any number of calls
+ *
+ * @param b byte received
+ */
+void Decoder_Feed(uint8_t b);
+
+#endif /* SCREEN_DECODER_H_ */